@@ -5,73 +5,36 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <unistd.h>
-#include <semaphore.h>
-#include <signal.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <time.h>
 #include <sys/shm.h>
-#include <sys/time.h>
-#include <stdarg.h>
+#include <sys/wait.h>
+
+#include "santa.h"
 
 // No valid input
 #define BAD_INPUT -1
-
-// Configurations from input arguments
-typedef struct configs {
-    int elf_num;          // Number of elves
-    int reindeer_num;     // Number of reindeer
-    int elf_work;         // Maximum time of individual elf's work (in ms)
-    int reindeer_holiday; // Maximum time of reindeer's holiday (in ms)
-} configs_t;
-
-// Shared data between all processes
-typedef struct shared_data {
-    // Semaphore for creating barrier for main process - it must wait for every child process to complete
-    sem_t main_barrier_sem;
-    // Semaphore for process process counting critical section (manipulating with ended_processes in shared_data)
-    sem_t end_process_counting_sem;
-    // Semaphore for process numbering critical section (manipulating with process_num in shared_data)
-    sem_t numbering_sem;
-    // Semaphore for counting reindeer critical section (manipulating with reindeer_home_num in shared_data)
-    sem_t reindeer_counting_sem;
-    // Semaphore for blocking Santa from waking up
-    // Santa is woken up when all of reindeer are at home or at least 3 elves need help
-    sem_t wake_santa_sem;
-    // Semaphore for blocking reindeer before they are hitched
-    sem_t reindeer_hitched_sem;
-    // Semaphore for blocking Santa from starting Christmas until all of reindeer are hitched
-    sem_t all_reindeer_hitched_sem;
-    // Semaphore for counting hitched reindeer (manipulating with reindeer_hitched_num in shared_data)
-    sem_t hitched_counting_sem;
-    // Semaphore for counting elves which need to help (manipulating with elf_need_help_num in shared_data)
-    sem_t elf_counting_sem;
-    // Semaphore for blocking elf until it get help from Santa
-    sem_t elf_got_help_sem;
-    // Semaphore for blocking elves from entering workshop, when its not empty
-    sem_t workshop_empty_sem;
-    // Semaphore for blocking santa until all elves in the workshop get help
-    sem_t elf_help_done_sem;
-
-    // Number of created (child) processes
-    int process_num;
-    // Number of ended (done) child processes
-    int ended_processes;
-    // Number of reindeer at home (back from holiday)
-    int reindeer_home_num;
-    // Number of hitched reindeer
-    int reindeer_hitched_num;
-    // Number of elves which ask for help
-    int elf_need_help_num;
-    // Is Santa's workshop opened?
-    bool workshop_open;
-} shared_data_t;
-
-// PIDs of running child processes
-typedef struct running_processes {
-    int num;    // Number of running processes
-    int pids[]; // PIDs of that processes
-} running_processes_t;
-
-// ID for elves and reindeer
-int id;
+// Maximum number of concurrently running simulations in sweep mode
+#define MAX_JOBS 1024
+// Maximum length of one line of the sweep file
+#define SWEEP_LINE_MAX 256
+
+// Options of the program (placed before positional arguments)
+typedef struct options {
+    char *sweep_file; // File with configurations to run in sweep mode (NULL => single simulation)
+    int jobs;         // Maximum number of concurrently running simulations in sweep mode
+} options_t;
+
+// One simulation of the sweep (stored in shared memory, so runners can fill results)
+typedef struct sweep_entry {
+    configs_t configs;     // Configurations of the simulation
+    int line_num;          // Line of the sweep file with the configuration (numbers output and dump)
+    int log_errno;         // Error number of failed opening of the log file (0 => log file has been opened)
+    bool done;             // Has the simulation been run?
+    santa_status_t status; // Result state of the simulation
+    santa_result_t result; // Result of the simulation
+} sweep_entry_t;
 
 // Help functions
 /**
@@ -83,199 +46,126 @@ int id;
  */
 int parse_input_arg(char *input_arg, int min, int max);
 /**
- * Logs an action
- * @param log_file Log file where to write the action to
- * @param shared_data Shared data (access to shared memory)
- * @param action Action name with tags (for ex. %d). Action number will be added automatically
- * @param ... Replacements for tags
+ * Parses time-scale factor
+ * @param input_arg Input argument to parse
+ * @param time_scale Pointer to the variable where to store parsed factor
+ * @return true => success, false => the argument is not valid
  */
-void log_action(FILE *log_file, shared_data_t *shared_data, const char *action, ...);
+bool parse_time_scale(char *input_arg, double *time_scale);
 
 // Initialization functions
 /**
- * Loads configurations from input arguments
+ * Loads options from input arguments
+ * Options change configurations shared by all simulations, too
  * @param configs Pointer to the structure to fill with loaded configurations
+ * @param options Pointer to the structure to fill with loaded options
+ * @param argc Number of input arguments
  * @param input_args Array of input arguments
- * @return true => success, false => problems with input arguments
+ * @return Index of the first positional argument or BAD_INPUT if some option is not valid
  */
-bool load_configurations(configs_t *configs, char **input_args);
+int load_options(configs_t *configs, options_t *options, int argc, char **input_args);
 /**
- * Prepares all required semaphores
- * Created semaphores can be safely destroyed by terminate_semaphores() function
- * <strong>Caution: After modifying this function the terminate_semaphores() function must be updated</strong>
- * @param shared_data Pointer to the shared data where to store semaphores
- * @return 0 => success, 1 => error while creating one of the semaphores
+ * Loads configurations from input arguments
+ * @param configs Pointer to the structure to fill with loaded configurations
+ * @param input_args Array of input arguments (positional arguments start at index 1)
+ * @return true => success, false => problems with input arguments
  */
-bool prepare_semaphores(shared_data_t *shared_data);
+bool load_configurations(configs_t *configs, char **input_args);
 /**
- * Destroys all semaphores created by prepare_semaphores() function
- * <strong>Caution: It needs to be updated after adding a new semaphore into prepare_semaphore()</strong>
- * @param shared_data Pointer to the shared data where to store semaphores
+ * Loads configurations of all simulations from the sweep file
+ * Every non-empty line contains NE NR TE TR, lines starting with '#' are comments
+ * @param file_name Name of the sweep file
+ * @param defaults Configurations shared by all simulations
+ * @param entries Pointer to the variable where to store allocated array of loaded simulations
+ * @return Number of loaded simulations or BAD_INPUT if the file cannot be loaded
  */
-void terminate_semaphores(shared_data_t *shared_data);
+int load_sweep_file(char *file_name, configs_t *defaults, sweep_entry_t **entries);
 
-// Work with child processes
-/**
- * Creates Santa process
- * @param configs Process configurations
- * @param log_file Log file where every action is logged to
- * @param shared_mem_id Identification of shared memory block
- * @param running_processes Running processes
- * @return true => success, false => problems with process creating
- */
-bool spawn_santa(configs_t *configs, FILE *log_file, int shared_mem_id, running_processes_t *running_processes);
+// Sweep mode
 /**
- * Creates elf processes
- * @param configs Process configurations
- * @param log_file Log file where every action is logged to
- * @param shared_mem_id Identification of shared memory block
- * @param running_processes Running processes
- * @return true => success, false => problems with process creating
+ * Runs all simulations from the sweep file concurrently and prints table of results
+ * Each simulation logs into its own file proj2-<line of the sweep file>.out
+ * @param configs Configurations shared by all simulations
+ * @param options Program options
+ * @return Exit code (0 => all simulations have been successful, 1 => error)
  */
-bool spawn_elves(configs_t *configs, FILE *log_file, int shared_mem_id, running_processes_t *running_processes);
+int run_sweep(configs_t *configs, options_t *options);
 /**
- * Creates reindeer processes
- * @param configs Process configurations
- * @param log_file Log file where every action is logged to
- * @param shared_mem_id Identification of shared memory block
- * @param running_processes Running processes
- * @return true => success, false => problems with process creating
+ * Writes line of the watchdog's dump to stderr prefixed by the line of the sweep file
+ * Dumps of concurrently running simulations can be told apart this way
+ * @param context Line of the sweep file (converted to pointer)
+ * @param line Line of the dump
+ * @param length Length of the line
+ * @return true => success, false => error while writing
  */
-bool spawn_reindeer(configs_t *configs, FILE *log_file, int shared_mem_id, running_processes_t *running_processes);
+bool sweep_dump_write(void *context, const char *line, size_t length);
 
 /**
  * Program for simulating Santa Claus live
- * @param argc Number of input arguments (5 required)
+ * Usage: proj2 [--time-scale F] [--watchdog MS [--watchdog-kill]] NE NR TE TR
+ *        proj2 [--time-scale F] [--watchdog MS [--watchdog-kill]] [--jobs N] --sweep FILE
+ * Watchdog dumps state of the stalled simulation to stderr
+ * @param argc Number of input arguments (at least 5 required, at least 3 in sweep mode)
  * @param argv Input arguments
  * @return Exit code (0 => success, 1 => error)
  */
 int main(int argc, char *argv[]) {
-    // Program need 4 explicit arguments (+ 1 implicit): NE NR TE TR
-    if (argc < 5) {
-        printf("Too few input arguments\n");
-
-        return 1;
-    }
-
-    // Load configurations from input arguments
+    // Load options from input arguments
     configs_t configs;
-    if (!load_configurations(&configs, argv)) {
-        printf( "Invalid input argument(s)\n");
+    options_t options;
+    int first_arg;
+    if ((first_arg = load_options(&configs, &options, argc, argv)) == BAD_INPUT) {
+        printf("Invalid input argument(s)\n");
 
         return 1;
     }
 
-    // Allocate memory for storing running processes' PIDs
-    running_processes_t *running_processes;
-    int number_of_processes = (1 + configs.elf_num + configs.reindeer_num);
-    if ((running_processes = malloc(sizeof(running_processes_t) + sizeof(int) * number_of_processes)) == NULL) {
-        printf("Cannot allocate memory for storing running processes' PIDs\n");
-
-        return 1;
-    }
+    // Configurations are loaded from the file in sweep mode
+    if (options.sweep_file != NULL) {
+        // Positional arguments would be ignored
+        if (first_arg < argc) {
+            printf("Invalid input argument(s)\n");
 
-    // Open file for logging actions
-    FILE *log_file;
-    if ((log_file = fopen("proj2.out", "w")) == NULL) {
-        printf("Cannot open log file\n");
-
-        free(running_processes);
-        return 1;
-    }
-
-    // Set unbuffered mode to the log file (every output will be written immediately)
-    if (setvbuf(log_file, NULL, _IONBF, 0) != 0) {
-        printf("Cannot set log file to unbuffered mode\n");
-
-        free(running_processes);
-        return 1;
-    }
-
-    // Prepare shared memory
-    int shared_mem_id;
-    if ((shared_mem_id = shmget(IPC_PRIVATE, sizeof(shared_data_t), 0600 | IPC_CREAT)) == -1) {
-        printf("Cannot get shared memory\n");
-
-        fclose(log_file);
-        free(running_processes);
-        return 1;
-    }
-
-    // Attach shared memory
-    shared_data_t *shared_data;
-    if ((shared_data = shmat(shared_mem_id, NULL, 0)) == (void *)-1) {
-        printf("Cannot attach shared memory\n");
+            return 1;
+        }
 
-        shmctl(shared_mem_id, IPC_RMID, 0);
-        fclose(log_file);
-        free(running_processes);
-        return 1;
+        return run_sweep(&configs, &options);
     }
 
-    // Prepare semaphores
-    if (!prepare_semaphores(shared_data)) {
-        printf("Cannot create one of the semaphores\n");
+    // Program need 4 explicit arguments (+ 1 implicit): NE NR TE TR
+    if (argc - first_arg < 4) {
+        printf("Too few input arguments\n");
 
-        shmdt(shared_data);
-        shmctl(shared_mem_id, IPC_RMID, 0);
-        fclose(log_file);
-        free(running_processes);
         return 1;
     }
 
-    // Workshop is opened, so elves can get help there
-    shared_data->workshop_open = true;
-
-    // Create needed processes
-    if (!spawn_santa(&configs, log_file, shared_mem_id, running_processes)) {
-        printf("Cannot create process for Santa\n");
+    // Load configurations from input arguments
+    if (!load_configurations(&configs, argv + first_arg - 1)) {
+        printf( "Invalid input argument(s)\n");
 
-        terminate_semaphores(shared_data);
-        shmdt(shared_data);
-        shmctl(shared_mem_id, IPC_RMID, 0);
-        fclose(log_file);
-        free(running_processes);
         return 1;
     }
-    if (!spawn_elves(&configs, log_file, shared_mem_id, running_processes)) {
-        printf("Cannot create process for elf\n");
 
-        // Terminate already run processes
-        for (int i = 0; i < running_processes->num; i++) {
-            kill(running_processes->pids[i], SIGKILL);
-        }
+    // Open file for logging actions
+    // Actions are written directly by write(), so there is no buffering
+    int log_fd;
+    if ((log_fd = open("proj2.out", O_WRONLY | O_CREAT | O_TRUNC, 0666)) == -1) {
+        printf("Cannot open log file\n");
 
-        terminate_semaphores(shared_data);
-        shmdt(shared_data);
-        shmctl(shared_mem_id, IPC_RMID, 0);
-        fclose(log_file);
-        free(running_processes);
         return 1;
     }
-    if (!spawn_reindeer(&configs, log_file, shared_mem_id, running_processes)) {
-        printf("Cannot create process for reindeer\n");
 
-        // Terminate already run processes
-        for (int i = 0; i < running_processes->num; i++) {
-            kill(running_processes->pids[i], SIGKILL);
-        }
+    // Run the simulation
+    santa_sink_t sink = santa_fd_sink(log_fd);
+    santa_status_t status;
+    if ((status = santa_run(&configs, &sink, NULL)) != SANTA_OK) {
+        printf("%s\n", santa_strerror(status));
 
-        terminate_semaphores(shared_data);
-        shmdt(shared_data);
-        shmctl(shared_mem_id, IPC_RMID, 0);
-        fclose(log_file);
-        free(running_processes);
+        close(log_fd);
         return 1;
     }
 
-    // Main process can end only if all child processes have ended
-    sem_wait(&shared_data->main_barrier_sem);
-
-    terminate_semaphores(shared_data);
-    shmdt(shared_data);
-    shmctl(shared_mem_id, IPC_RMID, 0);
-    fclose(log_file);
-    free(running_processes);
+    close(log_fd);
     return 0;
 }
 
@@ -309,22 +199,23 @@ int parse_input_arg(char *input_arg, int min, int max) {
 }
 
 /**
- * Loads configurations from input arguments
- * @param configs Pointer to the structure to fill with loaded configurations
- * @param input_args Array of input arguments
- * @return true => success, false => problems with input arguments
+ * Parses time-scale factor
+ * @param input_arg Input argument to parse
+ * @param time_scale Pointer to the variable where to store parsed factor
+ * @return true => success, false => the argument is not valid
  */
-bool load_configurations(configs_t *configs, char **input_args) {
-    if ((configs->elf_num = parse_input_arg(input_args[1], 1, 1000)) == BAD_INPUT) {
-        return false;
-    }
-    if ((configs->reindeer_num = parse_input_arg(input_args[2], 1, 19)) == BAD_INPUT) {
-        return false;
-    }
-    if ((configs->elf_work = parse_input_arg(input_args[3], 0, 1000)) == BAD_INPUT) {
+bool parse_time_scale(char *input_arg, double *time_scale) {
+    char *end;
+
+    errno = 0;
+    *time_scale = strtod(input_arg, &end);
+    if (end == input_arg || *end != '\0' || errno != 0) {
         return false;
     }
-    if ((configs->reindeer_holiday = parse_input_arg(input_args[4], 0, 1000)) == BAD_INPUT) {
+
+    // Check limits (negation catches NaN, too)
+    // Zero would mean real time in the library, so the smallest factor must be given explicitly
+    if (!(*time_scale > 0 && *time_scale <= SANTA_MAX_TIME_SCALE)) {
         return false;
     }
 
@@ -332,438 +223,340 @@ bool load_configurations(configs_t *configs, char **input_args) {
 }
 
 /**
- * Logs an action
- * @param log_file Log file where to write the action to
- * @param shared_data Shared data (access to shared memory)
- * @param action Action name with tags (for ex. %d). Action number will be added automatically
- * @param ... Replacements for tags
+ * Loads options from input arguments
+ * Options change configurations shared by all simulations, too
+ * @param configs Pointer to the structure to fill with loaded configurations
+ * @param options Pointer to the structure to fill with loaded options
+ * @param argc Number of input arguments
+ * @param input_args Array of input arguments
+ * @return Index of the first positional argument or BAD_INPUT if some option is not valid
  */
-void log_action(FILE *log_file, shared_data_t *shared_data, const char *action, ...) {
-    va_list tag_replacements;
+int load_options(configs_t *configs, options_t *options, int argc, char **input_args) {
+    // Simulation runs in real time without watchdog by default
+    memset(configs, 0, sizeof(configs_t));
+    configs->time_scale = 1;
+    configs->watchdog.stall_time = 0;
+    configs->watchdog.kill = false;
+    configs->watchdog.sink = santa_fd_sink(STDERR_FILENO);
+
+    // Sweep uses all available processors by default
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    options->sweep_file = NULL;
+    options->jobs = processors > 0 ? (processors < MAX_JOBS ? (int)processors : MAX_JOBS) : 1;
+
+    // Options are placed before positional arguments
+    int first_arg = 1;
+    while (first_arg < argc && strncmp(input_args[first_arg], "--", 2) == 0) {
+        if (strcmp(input_args[first_arg], "--time-scale") == 0 && first_arg + 1 < argc) {
+            if (!parse_time_scale(input_args[first_arg + 1], &configs->time_scale)) {
+                return BAD_INPUT;
+            }
 
-    va_start(tag_replacements, action);
+            first_arg += 2;
+        } else if (strcmp(input_args[first_arg], "--watchdog") == 0 && first_arg + 1 < argc) {
+            if ((configs->watchdog.stall_time = parse_input_arg(input_args[first_arg + 1], 1, SANTA_MAX_STALL_TIME))
+                == BAD_INPUT) {
+                return BAD_INPUT;
+            }
 
-    // Critical section - getting number and write alert into log file
-    sem_wait(&shared_data->numbering_sem);
-    int action_num = ++shared_data->process_num;
+            first_arg += 2;
+        } else if (strcmp(input_args[first_arg], "--watchdog-kill") == 0) {
+            configs->watchdog.kill = true;
 
-    fprintf(log_file, "%d: ", action_num);
-    vfprintf(log_file, action, tag_replacements);
-    fprintf(log_file, "\n");
-    sem_post(&shared_data->numbering_sem);
-    // END of critical section
+            first_arg++;
+        } else if (strcmp(input_args[first_arg], "--sweep") == 0 && first_arg + 1 < argc) {
+            options->sweep_file = input_args[first_arg + 1];
 
-    va_end(tag_replacements);
-}
+            first_arg += 2;
+        } else if (strcmp(input_args[first_arg], "--jobs") == 0 && first_arg + 1 < argc) {
+            if ((options->jobs = parse_input_arg(input_args[first_arg + 1], 1, MAX_JOBS)) == BAD_INPUT) {
+                return BAD_INPUT;
+            }
 
-/**
- * Prepares all required semaphores
- * Created semaphores can be safely destroyed by terminate_semaphores() function
- * <strong>Caution: After modifying this function the terminate_semaphores() function must be updated</strong>
- * @param shared_data Pointer to the shared data where to store semaphores
- * @return 0 => success, 1 => error while creating one of the semaphores
- */
-bool prepare_semaphores(shared_data_t *shared_data) {
-    // Init semaphore for process numbering
-    if ((sem_init(&shared_data->numbering_sem, 1, 1)) == -1) {
-        return false;
+            first_arg += 2;
+        } else {
+            return BAD_INPUT;
+        }
     }
 
-    // Init semaphore for blocking main process until all child processes are done
-    if ((sem_init(&shared_data->main_barrier_sem, 1, 0)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-        return false;
+    // Killing makes sense only with enabled watchdog
+    if (configs->watchdog.kill && configs->watchdog.stall_time == 0) {
+        return BAD_INPUT;
     }
 
-    // Init semaphore for counting ended processes
-    if ((sem_init(&shared_data->end_process_counting_sem, 1, 1)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-        return false;
-    }
+    return first_arg;
+}
 
-    // Init semaphore for counting reindeer at home
-    if ((sem_init(&shared_data->reindeer_counting_sem, 1, 1)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
+/**
+ * Loads configurations from input arguments
+ * @param configs Pointer to the structure to fill with loaded configurations
+ * @param input_args Array of input arguments (positional arguments start at index 1)
+ * @return true => success, false => problems with input arguments
+ */
+bool load_configurations(configs_t *configs, char **input_args) {
+    if ((configs->elf_num = parse_input_arg(input_args[1], 1, SANTA_MAX_ELVES)) == BAD_INPUT) {
         return false;
     }
-
-    // Init semaphore for blocking Santa from waking up
-    if ((sem_init(&shared_data->wake_santa_sem, 1, 0)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
+    if ((configs->reindeer_num = parse_input_arg(input_args[2], 1, SANTA_MAX_REINDEER)) == BAD_INPUT) {
         return false;
     }
-
-    // Init semaphore for blocking reindeer until its hitched 
-    if ((sem_init(&shared_data->reindeer_hitched_sem, 1, 0)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
+    if ((configs->elf_work = parse_input_arg(input_args[3], 0, SANTA_MAX_ELF_WORK)) == BAD_INPUT) {
         return false;
     }
-
-    // Init semaphore for blocking Santa to start Christmas
-    if ((sem_init(&shared_data->all_reindeer_hitched_sem, 1, 0)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
+    if ((configs->reindeer_holiday = parse_input_arg(input_args[4], 0, SANTA_MAX_REINDEER_HOLIDAY)) == BAD_INPUT) {
         return false;
     }
 
-    // Init semaphore for counting hitched reindeer
-    if ((sem_init(&shared_data->hitched_counting_sem, 1, 1)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-        return false;
-    }
+    return true;
+}
 
-    // Init semaphore for counting elves waiting for help
-    if ((sem_init(&shared_data->elf_counting_sem, 1, 1)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-        return false;
-    }
+/**
+ * Loads configurations of all simulations from the sweep file
+ * Every non-empty line contains NE NR TE TR, lines starting with '#' are comments
+ * @param file_name Name of the sweep file
+ * @param defaults Configurations shared by all simulations
+ * @param entries Pointer to the variable where to store allocated array of loaded simulations
+ * @return Number of loaded simulations or BAD_INPUT if the file cannot be loaded
+ */
+int load_sweep_file(char *file_name, configs_t *defaults, sweep_entry_t **entries) {
+    FILE *sweep_file;
+    if ((sweep_file = fopen(file_name, "r")) == NULL) {
+        printf("Cannot open sweep file\n");
 
-    if ((sem_init(&shared_data->elf_got_help_sem, 1, 0)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-        return false;
+        return BAD_INPUT;
     }
 
-    if ((sem_init(&shared_data->workshop_empty_sem, 1, 1)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-    }
+    *entries = NULL;
+    int count = 0;
+    int capacity = 0;
+    int line_num = 0;
+    char line[SWEEP_LINE_MAX];
+    while (fgets(line, sizeof(line), sweep_file) != NULL) {
+        line_num++;
 
-    if ((sem_init(&shared_data->elf_help_done_sem, 1, 0)) == -1) {
-        // Previous semaphores are already created, they need to be destroyed
-        terminate_semaphores(shared_data);
-    }
+        // Split line into arguments (index 0 is reserved to match layout of program's arguments)
+        char *args[6] = {NULL};
+        int arg_num = 0;
+        for (char *token = strtok(line, " \t\r\n"); token != NULL && arg_num < 5; token = strtok(NULL, " \t\r\n")) {
+            args[++arg_num] = token;
+        }
 
-    return true;
-}
+        // Skip empty lines and comments
+        if (arg_num == 0 || args[1][0] == '#') {
+            continue;
+        }
 
-/**
- * Destroys all semaphores created by prepare_semaphores() function
- * <strong>Caution: It needs to be updated after adding a new semaphore into prepare_semaphore()</strong>
- * @param shared_data Pointer to the shared data where to store semaphores
- */
-void terminate_semaphores(shared_data_t *shared_data) {
-    sem_destroy(&shared_data->numbering_sem);
-    sem_destroy(&shared_data->main_barrier_sem);
-    sem_destroy(&shared_data->end_process_counting_sem);
-    sem_destroy(&shared_data->reindeer_counting_sem);
-    sem_destroy(&shared_data->wake_santa_sem);
-    sem_destroy(&shared_data->reindeer_hitched_sem);
-    sem_destroy(&shared_data->all_reindeer_hitched_sem);
-    sem_destroy(&shared_data->hitched_counting_sem);
-    sem_destroy(&shared_data->elf_counting_sem);
-    sem_destroy(&shared_data->elf_got_help_sem);
-    sem_destroy(&shared_data->workshop_empty_sem);
-    sem_destroy(&shared_data->elf_help_done_sem);
-}
+        // Enlarge array of simulations
+        if (count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 16;
 
-/**
- * Creates Santa process
- * @param configs Process configurations
- * @param log_file Log file where every action is logged to
- * @param shared_mem_id Identification of shared memory block
- * @param running_processes Running processes
- * @return true => success, false => problems with process creating
- */
-bool spawn_santa(configs_t *configs, FILE *log_file, int shared_mem_id, running_processes_t *running_processes) {
-    // Create a new (child) process by dividing the main process into two processes
-    pid_t pid = fork();
-    if (pid == -1) {
-        // Error while creating the process (child process hasn't been created)
-        return false;
-    } else if (pid == 0) {
-        // Process has been successfully created --> this is code for the new (child) process
+            sweep_entry_t *enlarged;
+            if ((enlarged = realloc(*entries, sizeof(sweep_entry_t) * capacity)) == NULL) {
+                printf("Cannot allocate memory for sweep configurations\n");
 
-        // Attach shared memory
-        shared_data_t *shared_data;
-        if ((shared_data = shmat(shared_mem_id, NULL, 0)) == (void *)-1) {
-            return false;
+                free(*entries);
+                fclose(sweep_file);
+                return BAD_INPUT;
+            }
+            *entries = enlarged;
         }
 
-        // Santa sleeps until interrupt (see code in next block)
-        do {
-            log_action(log_file, shared_data, "Santa: going to sleep");
+        sweep_entry_t *entry = &(*entries)[count];
+        memset(entry, 0, sizeof(sweep_entry_t));
+        entry->configs = *defaults;
+        entry->line_num = line_num;
+        if (arg_num != 4 || !load_configurations(&entry->configs, args)) {
+            printf("Invalid configuration on line %d of sweep file\n", line_num);
 
-            // Sleep until at least 3 elves need help or the last reindeer come home
-            sem_wait(&shared_data->wake_santa_sem);
-            if (shared_data->reindeer_home_num == configs->reindeer_num) {
-                // All reindeer are at home --> let's hitch them
-                // After that Christmas will be started, so elves are without Santa's help from now
-                break;
-            } else {
-                // Elves need help
+            free(*entries);
+            fclose(sweep_file);
+            return BAD_INPUT;
+        }
 
-                log_action(log_file, shared_data, "Santa: helping elves");
+        count++;
+    }
 
-                // Help elves
-                for (int i = 0; i < 3; i++) {
-                    sem_post(&shared_data->elf_got_help_sem);
-                    sem_wait(&shared_data->elf_help_done_sem);
-                }
+    fclose(sweep_file);
+    return count;
+}
 
-                // Critical section - decrease number of elves waiting for help by 3 (Santa has helped them yet)
-                sem_wait(&shared_data->elf_counting_sem);
-                shared_data->elf_need_help_num -= 3;
-                sem_post(&shared_data->elf_counting_sem);
-                // END of critical section
+/**
+ * Runs all simulations from the sweep file concurrently and prints table of results
+ * Each simulation logs into its own file proj2-<line of the sweep file>.out
+ * @param configs Configurations shared by all simulations
+ * @param options Program options
+ * @return Exit code (0 => all simulations have been successful, 1 => error)
+ */
+int run_sweep(configs_t *configs, options_t *options) {
+    // Load configurations of simulations
+    sweep_entry_t *loaded_entries;
+    int count;
+    if ((count = load_sweep_file(options->sweep_file, configs, &loaded_entries)) == BAD_INPUT) {
+        return 1;
+    }
+    if (count == 0) {
+        printf("No configuration in sweep file\n");
 
-                // Workshop is empty now
-                sem_post(&shared_data->workshop_empty_sem);
-            }
-        } while (1);
+        free(loaded_entries);
+        return 1;
+    }
 
-        // Workshop is closed now, so elves can't get help and should go to holiday
-        log_action(log_file, shared_data, "Santa: closing workshop");
-        shared_data->workshop_open = false;
+    // Prepare shared memory for results (each simulation runs in its own runner process)
+    int shared_mem_id;
+    if ((shared_mem_id = shmget(IPC_PRIVATE, sizeof(sweep_entry_t) * count, 0600 | IPC_CREAT)) == -1) {
+        printf("Cannot get shared memory\n");
 
-        // Send waiting elves to holiday
-        // Some of elves aren't at holiday right now and didn't see the info sign at the workshop says "closed"
-        for (int i = 0; i < shared_data->elf_need_help_num; i++) {
-            sem_post(&shared_data->workshop_empty_sem);
-            sem_post(&shared_data->elf_got_help_sem);
-        }
+        free(loaded_entries);
+        return 1;
+    }
 
-        // Hitch reindeer
-        for (int i = 0; i < configs->reindeer_num; i++) {
-            sem_post(&shared_data->reindeer_hitched_sem);
-        }
+    // Attach shared memory
+    sweep_entry_t *entries;
+    if ((entries = shmat(shared_mem_id, NULL, 0)) == (void *)-1) {
+        printf("Cannot attach shared memory\n");
+
+        shmctl(shared_mem_id, IPC_RMID, 0);
+        free(loaded_entries);
+        return 1;
+    }
+    shmctl(shared_mem_id, IPC_RMID, 0);
+    memcpy(entries, loaded_entries, sizeof(sweep_entry_t) * count);
+    free(loaded_entries);
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    // Runners mustn't flush the parent's buffered output again
+    fflush(stdout);
+
+    // Run simulations - at most options->jobs at once
+    int running = 0;
+    int next = 0;
+    bool fork_failed = false; // No runner can be created until some of running ones ends
+    while (next < count || running > 0) {
+        if (next < count && running < options->jobs && !fork_failed) {
+            // Create a new runner process for the next simulation
+            pid_t pid = fork();
+            if (pid == -1) {
+                if (running > 0) {
+                    // Processes are probably exhausted by running simulations - retry after some of them ends
+                    fork_failed = true;
+                    continue;
+                }
 
-        // Wait for all reindeer are hitched
-        sem_wait(&shared_data->all_reindeer_hitched_sem);
+                // Error while creating the process - simulation stays marked as not done
+                printf("Cannot create process for simulation on line %d\n", entries[next].line_num);
 
-        log_action(log_file, shared_data, "Santa: Christmas started");
+                next++;
+                continue;
+            } else if (pid == 0) {
+                // This is code for the runner process
+                sweep_entry_t *entry = &entries[next];
 
-        // Child process is done
-        // Critical section - incrementing end processes number
-        sem_wait(&shared_data->end_process_counting_sem);
-        shared_data->ended_processes++;
-        sem_post(&shared_data->end_process_counting_sem);
-        // END of critical section
+                // Every simulation logs into its own file
+                char log_name[32];
+                snprintf(log_name, sizeof(log_name), "proj2-%d.out", entry->line_num);
 
-        // Allow main process to exit
-        if (shared_data->ended_processes == (1 + configs->elf_num + configs->reindeer_num)) {
-            sem_post(&shared_data->main_barrier_sem);
-        }
+                int log_fd;
+                if ((log_fd = open(log_name, O_WRONLY | O_CREAT | O_TRUNC, 0666)) == -1) {
+                    entry->log_errno = errno;
 
-        shmdt(shared_data);
-        exit(0);
-    } else {
-        // Process has been successfully created --> this is code for original (main) process
-        running_processes->pids[running_processes->num++] = pid;
-    }
+                    shmdt(entries);
+                    _exit(1);
+                }
 
-    return true;
-}
+                // Dump lines of the watchdog are marked by the simulation they belong to
+                entry->configs.watchdog.sink = santa_callback_sink(sweep_dump_write,
+                                                                   (void *)(intptr_t)entry->line_num);
 
-/**
- * Creates elf processes
- * @param configs Process configurations
- * @param log_file Log file where every action is logged to
- * @param shared_mem_id Identification of shared memory block
- * @param running_processes Running processes
- * @return true => success, false => problems with process creating
- */
-bool spawn_elves(configs_t *configs, FILE *log_file, int shared_mem_id, running_processes_t *running_processes) {
-    for (int i = 0; i < configs->elf_num; i++) {
-        // Create a new (child) process by dividing the main process into two processes
-        pid_t pid = fork();
-        if (pid == -1) {
-            // Error while creating the process (child process hasn't been created)
-            return false;
-        } else if (pid == 0) {
-            // Process has been successfully created --> this is code for the new (child) process
-
-            // Attach shared memory
-            shared_data_t *shared_data;
-            if ((shared_data = shmat(shared_mem_id, NULL, 0)) == (void *)-1) {
-                return false;
+                santa_sink_t sink = santa_fd_sink(log_fd);
+                entry->status = santa_run(&entry->configs, &sink, &entry->result);
+                entry->done = true;
+
+                close(log_fd);
+                shmdt(entries);
+                _exit(0);
             }
 
-            // Set identifier
-            id = i + 1;
-
-            // Notify about start working action
-            log_action(log_file, shared_data, "Elf %d: started", id);
-
-            // Elf's working
-            do {
-                // Prepare for randomization - construct seed
-                // Seed is constructed from PID of the child process and microseconds of the current time
-                struct timeval current_time;
-                gettimeofday(&current_time, NULL);
-                srand(getpid() + current_time.tv_usec);
-
-                // Simulate individual working for a pseudorandom time
-                int work_time = rand() % (configs->elf_work + 1);
-                usleep(work_time * 1000); // * 1000 => convert milliseconds to microseconds
-
-                log_action(log_file, shared_data, "Elf %d: need help", id);
-
-                if (!shared_data->workshop_open) {
-                    // Santa has already started Christmas, so the elf goes to holiday
-
-                    log_action(log_file, shared_data, "Elf %d: taking holidays", id);
-                    break;
-                } else {
-                    // Critical section - counting elves waiting for help
-                    sem_wait(&shared_data->elf_counting_sem);
-                    shared_data->elf_need_help_num++;
-                    sem_post(&shared_data->elf_counting_sem);
-                    // END of critical section
-
-                    // Wake up Santa if elf is the 3rd in the queue
-                    if (shared_data->elf_need_help_num % 3 == 0) {
-                        // Waiting for open workshop
-                        sem_wait(&shared_data->workshop_empty_sem);
-
-                        // Workshop won't be opened --> Santa is hitching reindeer and Christmas will start in a while
-                        if (!shared_data->workshop_open) {
-                            log_action(log_file, shared_data, "Elf %d: taking holidays", id);
-                            break;
-                        }
-
-                        // Wake up Santa
-                        sem_post(&shared_data->wake_santa_sem);
-                    }
-
-                    // Wait for Santa's help
-                    sem_wait(&shared_data->elf_got_help_sem);
-
-                    if (shared_data->workshop_open) {
-                        // Elf got help from Santa
-
-                        log_action(log_file, shared_data, "Elf %d: get help", id);
-                        sem_post(&shared_data->elf_help_done_sem);
-                    } else {
-                        // Christmas has started yet, so elf won't get help and must go to holiday
-
-                        log_action(log_file, shared_data, "Elf %d: taking holidays", id);
-                        break;
-                    }
-
-                    // Start next individual work...
+            running++;
+            next++;
+        } else {
+            // Wait for any runner to end (interrupted waiting hasn't reaped anything)
+            if (wait(NULL) == -1) {
+                if (errno == EINTR) {
+                    continue;
                 }
-            } while (1);
-
-            // Child process is done
-            // Critical section - incrementing end processes number
-            sem_wait(&shared_data->end_process_counting_sem);
-            shared_data->ended_processes++;
-            sem_post(&shared_data->end_process_counting_sem);
-            // END of critical section
-
-            // Allow main process to exit
-            if (shared_data->ended_processes == (1 + configs->elf_num + configs->reindeer_num)) {
-                sem_post(&shared_data->main_barrier_sem);
+
+                // There is no runner to wait for (it shouldn't happen)
+                break;
             }
 
-            shmdt(shared_data);
-            exit(0);
-        } else {
-            // Process has been successfully created --> this is code for original (main) process
-            running_processes->pids[running_processes->num++] = pid;
+            running--;
+            fork_failed = false;
         }
     }
 
-    return true;
-}
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double elapsed_ms = (double)(end_time.tv_sec - start_time.tv_sec) * 1000
+                        + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1000000;
 
-/**
- * Creates reindeer processes
- * @param configs Process configurations
- * @param log_file Log file where every action is logged to
- * @param shared_mem_id Identification of shared memory block
- * @param running_processes Running processes
- * @return true => success, false => problems with process creating
- */
-bool spawn_reindeer(configs_t *configs, FILE *log_file, int shared_mem_id, running_processes_t *running_processes) {
-    for (int i = 0; i < configs->reindeer_num; i++) {
-        // Create a new (child) process by dividing the main process into two processes
-        pid_t pid = fork();
-        if (pid == -1) {
-            // Error while creating the process (child process hasn't been created)
-            return false;
-        } else if (pid == 0) {
-            // Process has been successfully created --> this is code for the new (child) process
-
-            // Attach shared memory
-            shared_data_t *shared_data;
-            if ((shared_data = shmat(shared_mem_id, NULL, 0)) == (void *)-1) {
-                printf("%d\n", shared_mem_id);
-                return false;
-            }
-            // Set identifier
-            id = i + 1;
-
-            // Notify about go to holiday action
-            log_action(log_file, shared_data, "RD %d: rstarted", id);
-
-            // Prepare for randomization - construct seed
-            // Seed is constructed from PID of the child process and microseconds of the current time
-            struct timeval current_time;
-            gettimeofday(&current_time, NULL);
-            srand(getpid() + current_time.tv_usec);
-
-            // Simulate holiday for a pseudorandom time
-            int holiday_time = (rand() + (configs->reindeer_holiday / 2)) % (configs->reindeer_holiday + 1);
-            usleep(holiday_time * 1000); // * 1000 => convert milliseconds to microseconds
-
-            // Let know reindeer is back at home
-            log_action(log_file, shared_data, "RD %d: return home", id);
-
-            // Increment number of returned reindeer
-            sem_wait(&shared_data->reindeer_counting_sem);
-            shared_data->reindeer_home_num++;
-            sem_post(&shared_data->reindeer_counting_sem);
-
-            // Waiting for all reindeer are at home to start Christmas
-            // The last-returned reindeer wakes Santa up and he can start hitching reindeer
-            if (shared_data->reindeer_home_num == configs->reindeer_num) {
-                sem_post(&shared_data->wake_santa_sem);
-            }
+    // Print table of results
+    int failed = 0;
+    printf("%4s %5s %3s %5s %5s %8s %6s %6s %12s  %-16s %s\n", "#", "NE", "NR", "TE", "TR", "actions", "helps",
+           "stalls", "elapsed [ms]", "output", "status");
+    for (int i = 0; i < count; i++) {
+        sweep_entry_t *entry = &entries[i];
 
-            // Wait for the time the reindeer is hitched
-            sem_wait(&shared_data->reindeer_hitched_sem);
+        char log_name[32];
+        snprintf(log_name, sizeof(log_name), "proj2-%d.out", entry->line_num);
 
-            log_action(log_file, shared_data, "RD %d: get hitched", id);
+        if (!entry->done) {
+            char reason[128];
+            if (entry->log_errno != 0) {
+                snprintf(reason, sizeof(reason), "Cannot open log file: %s", strerror(entry->log_errno));
+            } else {
+                snprintf(reason, sizeof(reason), "Simulation hasn't been run");
+            }
 
-            // Critical section - counting hitched reindeer
-            sem_wait(&shared_data->hitched_counting_sem);
-            shared_data->reindeer_hitched_num++;
-            sem_post(&shared_data->hitched_counting_sem);
-            // END of critical section
+            printf("%4d %5d %3d %5d %5d %8s %6s %6s %12s  %-16s %s\n", entry->line_num, entry->configs.elf_num,
+                   entry->configs.reindeer_num, entry->configs.elf_work, entry->configs.reindeer_holiday, "-", "-",
+                   "-", "-", log_name, reason);
+            failed++;
+            continue;
+        }
 
-            // All reindeer are hitched --> Santa can start Christmas
-            if (shared_data->reindeer_hitched_num == configs->reindeer_num) {
-                sem_post(&shared_data->all_reindeer_hitched_sem);
-            }
+        printf("%4d %5d %3d %5d %5d %8d %6d %6d %12.3f  %-16s %s\n", entry->line_num, entry->configs.elf_num,
+               entry->configs.reindeer_num, entry->configs.elf_work, entry->configs.reindeer_holiday,
+               entry->result.actions, entry->result.help_rounds, entry->result.stalls, entry->result.elapsed_ms,
+               log_name, santa_strerror(entry->status));
+        if (entry->status != SANTA_OK) {
+            failed++;
+        }
+    }
+    printf("%d simulations (%d failed) in %.3f ms using %d jobs\n", count, failed, elapsed_ms, options->jobs);
 
-            // Child process is done
-            // Critical section - incrementing end processes number
-            sem_wait(&shared_data->end_process_counting_sem);
-            shared_data->ended_processes++;
-            sem_post(&shared_data->end_process_counting_sem);
-            // END of critical section
+    shmdt(entries);
+    return failed > 0 ? 1 : 0;
+}
 
-            // Allow main process to exit
-            if (shared_data->ended_processes == (1 + configs->elf_num + configs->reindeer_num)) {
-                sem_post(&shared_data->main_barrier_sem);
-            }
+/**
+ * Writes line of the watchdog's dump to stderr prefixed by the line of the sweep file
+ * Dumps of concurrently running simulations can be told apart this way
+ * @param context Line of the sweep file (converted to pointer)
+ * @param line Line of the dump
+ * @param length Length of the line
+ * @return true => success, false => error while writing
+ */
+bool sweep_dump_write(void *context, const char *line, size_t length) {
+    char prefixed_line[SWEEP_LINE_MAX + 512];
 
-            shmdt(shared_data);
-            exit(0);
-        } else {
-            // Process has been successfully created --> this is code for original (main) process
-            running_processes->pids[running_processes->num++] = pid;
-        }
+    int prefix_length = snprintf(prefixed_line, sizeof(prefixed_line), "[line %d] ", (int)(intptr_t)context);
+    if (length > sizeof(prefixed_line) - prefix_length) {
+        length = sizeof(prefixed_line) - prefix_length;
     }
+    memcpy(prefixed_line + prefix_length, line, length);
 
-    return true;
+    // Whole line is written at once, so lines of concurrent dumps don't mix
+    return write(STDERR_FILENO, prefixed_line, prefix_length + length) == (ssize_t)(prefix_length + length);
 }
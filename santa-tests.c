@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "santa.h"
+
+// Checks condition and reports failed one
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+// Number of failed checks
+int failed_checks = 0;
+
+// Counters for the callback sink
+typedef struct line_counter {
+    int lines;    // Number of received lines
+    int bad_ends; // Number of lines not terminated by '\n'
+} line_counter_t;
+
+/**
+ * Reports failed check
+ * @param condition Result of the check
+ * @param text Text of the checked condition
+ * @param line Line of the check
+ */
+void check(bool condition, const char *text, int line) {
+    if (!condition) {
+        printf("FAILED (line %d): %s\n", line, text);
+        failed_checks++;
+    }
+}
+
+/**
+ * Counts lines of the text
+ * @param text Text to count lines of
+ * @param length Length of the text
+ * @return Number of '\n' characters in the text
+ */
+int count_lines(const char *text, size_t length) {
+    int lines = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') {
+            lines++;
+        }
+    }
+
+    return lines;
+}
+
+/**
+ * Callback sink counting received lines
+ * @param context Line counter
+ * @param line Logged action
+ * @param length Length of the logged action
+ * @return Always true
+ */
+bool count_line(void *context, const char *line, size_t length) {
+    line_counter_t *counter = context;
+
+    counter->lines++;
+    if (length == 0 || line[length - 1] != '\n') {
+        counter->bad_ends++;
+    }
+
+    return true;
+}
+
+/**
+ * Callback sink refusing every line
+ * @param context Unused
+ * @param line Unused
+ * @param length Unused
+ * @return Always false
+ */
+bool refuse_line(void *context, const char *line, size_t length) {
+    (void)context;
+    (void)line;
+    (void)length;
+
+    return false;
+}
+
+/**
+ * Checks that elves get help in order of their tickets and in groups of exactly 3
+ * Elves take tickets in the same order as they log "need help"
+ * @param log Logged actions (null-terminated)
+ * @param result Result of the simulation
+ * @param elf_num Number of elves
+ * @return true => elves have been served in FIFO order, false => otherwise
+ */
+bool check_elf_queue(const char *log, const santa_result_t *result, int elf_num) {
+    // Elves in order of their tickets
+    int *queue = malloc(result->actions * sizeof(int));
+    if (queue == NULL) {
+        return false;
+    }
+
+    int queued = 0;
+    int served = 0;
+    int group = -1; // Number of elves helped in the current round (-1 => Santa isn't helping elves)
+    int holidays = 0;
+    bool closed = false;
+    bool valid = true;
+
+    const char *line_start = log;
+    const char *line_end;
+    while ((line_end = strchr(line_start, '\n')) != NULL) {
+        char line[256];
+        snprintf(line, sizeof(line), "%.*s", (int)(line_end - line_start), line_start);
+        line_start = line_end + 1;
+
+        int elf;
+        char action[64];
+        if (sscanf(line, "%*d: Elf %d: %63[^\n]", &elf, action) == 2) {
+            if (strcmp(action, "need help") == 0) {
+                queue[queued++] = elf;
+            } else if (strcmp(action, "get help") == 0) {
+                // Only the oldest ticket can be served and only as a part of the current group
+                valid = valid && !closed && group >= 0 && group < 3 && served < queued && queue[served] == elf;
+                served++;
+                group++;
+            } else if (strcmp(action, "taking holidays") == 0) {
+                holidays++;
+            }
+        } else if (sscanf(line, "%*d: Santa: %63[^\n]", action) == 1) {
+            // Previous group must be complete whenever Santa does something else
+            valid = valid && (group == -1 || group == 3);
+            group = strcmp(action, "helping elves") == 0 ? 0 : -1;
+
+            if (strcmp(action, "closing workshop") == 0) {
+                closed = true;
+            }
+        }
+    }
+    free(queue);
+
+    // Every elf ends up on holidays (elves still queued are sent there when the workshop closes)
+    return valid && served == result->help_rounds * 3 && holidays == elf_num;
+}
+
+/**
+ * Tests for the public API of the simulation library
+ * @return Exit code (0 => all tests passed, 1 => some test failed)
+ */
+int main(void) {
+    configs_t configs = {
+        .elf_num = 10,
+        .reindeer_num = 5,
+        .elf_work = 100,
+        .reindeer_holiday = 100,
+        .time_scale = 0.01,
+    };
+    santa_result_t result;
+
+    // Buffer sink
+    santa_buffer_t buffer = {0};
+    santa_sink_t buffer_sink = santa_buffer_sink(&buffer);
+    CHECK(santa_run(&configs, &buffer_sink, &result) == SANTA_OK);
+    CHECK(buffer.data != NULL && strlen(buffer.data) == buffer.length);
+    CHECK(buffer.data != NULL && count_lines(buffer.data, buffer.length) == result.actions);
+    CHECK(buffer.data != NULL && strncmp(buffer.data, "1: ", 3) == 0);
+    CHECK(result.reindeer_hitched == configs.reindeer_num);
+    CHECK(result.stalls == 0);
+    CHECK(result.elapsed_ms > 0);
+    free(buffer.data);
+
+    // Callback sink
+    line_counter_t counter = {0, 0};
+    santa_sink_t callback_sink = santa_callback_sink(count_line, &counter);
+    CHECK(santa_run(&configs, &callback_sink, &result) == SANTA_OK);
+    CHECK(counter.lines == result.actions);
+    CHECK(counter.bad_ends == 0);
+
+    // File descriptor sink
+    FILE *log_file;
+    CHECK((log_file = tmpfile()) != NULL);
+    if (log_file != NULL) {
+        santa_sink_t fd_sink = santa_fd_sink(fileno(log_file));
+        CHECK(santa_run(&configs, &fd_sink, &result) == SANTA_OK);
+
+        char content[65536];
+        rewind(log_file);
+        size_t length = fread(content, 1, sizeof(content), log_file);
+        CHECK(count_lines(content, length) == result.actions);
+        fclose(log_file);
+    }
+
+    // Zero-initialized time-scale factor means real time (reindeer's holidays take tens of ms)
+    configs_t real_time_configs = {
+        .elf_num = 3,
+        .reindeer_num = SANTA_MAX_REINDEER,
+        .elf_work = 0,
+        .reindeer_holiday = 100,
+    };
+    CHECK(santa_run(&real_time_configs, &callback_sink, &result) == SANTA_OK);
+    CHECK(result.elapsed_ms >= 20);
+
+    // Elf queue - FIFO groups of 3 (fewer than 3 elves are parked until the workshop closes)
+    int elf_nums[] = {1, 2, 5, 7, 12};
+    for (size_t i = 0; i < sizeof(elf_nums) / sizeof(elf_nums[0]); i++) {
+        for (int round = 0; round < 5; round++) {
+            configs_t queue_configs = configs;
+            queue_configs.elf_num = elf_nums[i];
+
+            santa_buffer_t queue_buffer = {0};
+            santa_sink_t queue_sink = santa_buffer_sink(&queue_buffer);
+            CHECK(santa_run(&queue_configs, &queue_sink, &result) == SANTA_OK);
+            CHECK(queue_buffer.data != NULL && check_elf_queue(queue_buffer.data, &result, queue_configs.elf_num));
+            if (queue_configs.elf_num < 3) {
+                CHECK(result.help_rounds == 0);
+            }
+            free(queue_buffer.data);
+        }
+    }
+
+    // Sink refusing logged actions
+    santa_sink_t refusing_sink = santa_callback_sink(refuse_line, NULL);
+    CHECK(santa_run(&configs, &refusing_sink, NULL) == SANTA_ERR_SINK);
+
+    // Invalid configurations and sinks
+    configs_t invalid_configs = configs;
+    invalid_configs.elf_num = 0;
+    CHECK(santa_run(&invalid_configs, &callback_sink, NULL) == SANTA_ERR_CONFIG);
+    invalid_configs = configs;
+    invalid_configs.reindeer_num = SANTA_MAX_REINDEER + 1;
+    CHECK(santa_run(&invalid_configs, &callback_sink, NULL) == SANTA_ERR_CONFIG);
+    invalid_configs = configs;
+    invalid_configs.watchdog.stall_time = 100;
+    CHECK(santa_run(&invalid_configs, &callback_sink, NULL) == SANTA_ERR_CONFIG);
+    CHECK(santa_run(&configs, NULL, NULL) == SANTA_ERR_CONFIG);
+    santa_sink_t empty_sink = {NULL, NULL};
+    CHECK(santa_run(&configs, &empty_sink, NULL) == SANTA_ERR_CONFIG);
+
+    // Every status has its description
+    for (int status = SANTA_OK; status <= SANTA_ERR_STALL; status++) {
+        CHECK(strcmp(santa_strerror((santa_status_t)status), "Unknown error") != 0);
+    }
+
+    if (failed_checks > 0) {
+        printf("%d check(s) failed\n", failed_checks);
+
+        return 1;
+    }
+
+    printf("All checks passed\n");
+    return 0;
+}
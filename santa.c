@@ -0,0 +1,1114 @@
+#include "santa.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/shm.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <stdarg.h>
+
+// Maximum length of one logged action (including line number and '\n')
+#define LOG_LINE_MAX 128
+// Size of the chunk read from the log pipe at once
+#define LOG_READ_CHUNK 4096
+// Number of nanoseconds in one millisecond and one second
+#define NS_PER_MS 1000000LL
+#define NS_PER_S 1000000000LL
+
+// Last logged action of one actor
+typedef struct actor_state {
+    char action[LOG_LINE_MAX]; // Logged line without '\n' (empty => nothing has been logged yet)
+} actor_state_t;
+
+// Slot of the elf queue - elf holding ticket T waits in slot T % (number of elves)
+// There are never more waiting elves than elves, so every waiting elf has its own slot
+typedef struct elf_slot {
+    sem_t got_help_sem; // Semaphore for blocking the elf until it get help from Santa (or workshop is closed)
+} elf_slot_t;
+
+// Shared data between all processes
+typedef struct shared_data {
+    // Semaphore for process numbering critical section (manipulating with process_num in shared_data)
+    sem_t numbering_sem;
+    // Semaphore for counting reindeer critical section (manipulating with reindeer_home_num in shared_data)
+    sem_t reindeer_counting_sem;
+    // Semaphore for blocking Santa from waking up
+    // Santa is woken up when all of reindeer are at home or at least 3 elves need help
+    sem_t wake_santa_sem;
+    // Semaphore for blocking reindeer before they are hitched
+    sem_t reindeer_hitched_sem;
+    // Semaphore for blocking Santa from starting Christmas until all of reindeer are hitched
+    sem_t all_reindeer_hitched_sem;
+    // Semaphore for counting hitched reindeer (manipulating with reindeer_hitched_num in shared_data)
+    sem_t hitched_counting_sem;
+    // Semaphore for giving tickets to elves which need help (manipulating with next_ticket in shared_data)
+    sem_t elf_counting_sem;
+    // Semaphore for blocking santa until all elves in the workshop get help
+    sem_t elf_help_done_sem;
+
+    // Number of logged actions
+    int process_num;
+    // Number of reindeer at home (back from holiday)
+    int reindeer_home_num;
+    // Number of hitched reindeer
+    int reindeer_hitched_num;
+    // Ticket for the next elf which asks for help (tickets are served in FIFO order in groups of 3)
+    int next_ticket;
+    // Number of served tickets (the first ticket of the next group), only Santa changes it
+    int served_tickets;
+    // How many times Santa has helped elves
+    int help_rounds;
+    // Is Santa's workshop opened?
+    bool workshop_open;
+
+    // Slots of the elf queue (placed in shared memory right after actors)
+    elf_slot_t *elf_slots;
+
+    // Last logged actions of actors (Santa, elves and reindeer in this order)
+    actor_state_t actors[];
+} shared_data_t;
+
+// PIDs of running child processes
+typedef struct running_processes {
+    int num;    // Number of running processes
+    int pids[]; // PIDs of that processes
+} running_processes_t;
+
+// ID for elves and reindeer
+static int id;
+// Index of the process in shared_data->actors (Santa, elves and reindeer in this order)
+static int actor;
+
+// Help functions
+/**
+ * Logs an action
+ * @param log_fd Write end of the log pipe where to write the action to
+ * @param shared_data Shared data (access to shared memory)
+ * @param action Action name with tags (for ex. %d). Action number will be added automatically
+ * @param ... Replacements for tags
+ */
+static void log_action(int log_fd, shared_data_t *shared_data, const char *action, ...);
+/**
+ * Simulates an activity taking the given time (scaled by the time-scale factor)
+ * The process sleeps until an absolute deadline, so interrupted sleeps don't prolong the activity
+ * @param configs Simulation configurations (contains time-scale factor)
+ * @param duration Simulated time of the activity (in ms)
+ */
+static void simulate_activity(const configs_t *configs, int duration);
+/**
+ * Passes logged actions from the log pipe to the sink until all child processes close the pipe
+ * If the watchdog is enabled, it checks if there is any progress
+ * @param log_fd Read end of the log pipe
+ * @param sink Sink where to write logged actions to
+ * @param configs Simulation configurations (contains watchdog settings)
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @param stalls Pointer to the variable where to count detected stalls
+ * @return SANTA_OK => success, SANTA_ERR_PIPE => cannot read the log pipe,
+ *         SANTA_ERR_SINK => sink has refused logged action,
+ *         SANTA_ERR_STALL => simulation has stalled and the watchdog should kill it
+ */
+static santa_status_t collect_actions(int log_fd, const santa_sink_t *sink, const configs_t *configs,
+                                      shared_data_t *shared_data, running_processes_t *running_processes,
+                                      int *stalls);
+/**
+ * Writes state of the simulation into the watchdog's sink
+ * @param configs Simulation configurations (contains watchdog settings)
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ */
+static void dump_state(const configs_t *configs, shared_data_t *shared_data, running_processes_t *running_processes);
+/**
+ * Writes one formatted line into the sink
+ * @param sink Sink where to write the line to
+ * @param format Line format (without '\n')
+ * @param ... Replacements for tags
+ */
+static void dump_line(const santa_sink_t *sink, const char *format, ...);
+/**
+ * Waits for all child processes to end
+ * @param running_processes Running processes
+ * @return true => all processes have ended successfully, false => some of them has ended abnormally
+ */
+static bool wait_for_processes(running_processes_t *running_processes);
+/**
+ * Kills all running child processes and waits for them
+ * @param running_processes Running processes
+ */
+static void kill_processes(running_processes_t *running_processes);
+
+// Initialization functions
+/**
+ * Prepares all required semaphores
+ * Created semaphores can be safely destroyed by terminate_semaphores() function
+ * <strong>Caution: After modifying this function the terminate_semaphores() function must be updated</strong>
+ * @param shared_data Pointer to the shared data where to store semaphores
+ * @param elf_num Number of elves (slots of the elf queue)
+ * @return true => success, false => error while creating one of the semaphores
+ */
+static bool prepare_semaphores(shared_data_t *shared_data, int elf_num);
+/**
+ * Destroys all semaphores created by prepare_semaphores() function
+ * <strong>Caution: It needs to be updated after adding a new semaphore into prepare_semaphore()</strong>
+ * @param shared_data Pointer to the shared data where to store semaphores
+ * @param elf_num Number of elves (slots of the elf queue)
+ */
+static void terminate_semaphores(shared_data_t *shared_data, int elf_num);
+
+// Work with child processes
+/**
+ * Creates Santa process
+ * @param configs Process configurations
+ * @param log_fd Write end of the log pipe where every action is logged to
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @return true => success, false => problems with process creating
+ */
+static bool spawn_santa(const configs_t *configs, int log_fd, shared_data_t *shared_data,
+                        running_processes_t *running_processes);
+/**
+ * Creates elf processes
+ * @param configs Process configurations
+ * @param log_fd Write end of the log pipe where every action is logged to
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @return true => success, false => problems with process creating
+ */
+static bool spawn_elves(const configs_t *configs, int log_fd, shared_data_t *shared_data,
+                        running_processes_t *running_processes);
+/**
+ * Creates reindeer processes
+ * @param configs Process configurations
+ * @param log_fd Write end of the log pipe where every action is logged to
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @return true => success, false => problems with process creating
+ */
+static bool spawn_reindeer(const configs_t *configs, int log_fd, shared_data_t *shared_data,
+                           running_processes_t *running_processes);
+
+// Sink writers
+static bool fd_sink_write(void *context, const char *line, size_t length);
+static bool buffer_sink_write(void *context, const char *line, size_t length);
+
+/**
+ * Checks configurations against limits
+ * @param configs Configurations to check
+ * @return true => configurations are valid, false => some of them is out of limits
+ */
+bool santa_check_configs(const configs_t *configs) {
+    if (configs->elf_num < 1 || configs->elf_num > SANTA_MAX_ELVES) {
+        return false;
+    }
+    if (configs->reindeer_num < 1 || configs->reindeer_num > SANTA_MAX_REINDEER) {
+        return false;
+    }
+    if (configs->elf_work < 0 || configs->elf_work > SANTA_MAX_ELF_WORK) {
+        return false;
+    }
+    if (configs->reindeer_holiday < 0 || configs->reindeer_holiday > SANTA_MAX_REINDEER_HOLIDAY) {
+        return false;
+    }
+    if (!(configs->time_scale >= 0 && configs->time_scale <= SANTA_MAX_TIME_SCALE)) {
+        return false;
+    }
+    if (configs->watchdog.stall_time < 0 || configs->watchdog.stall_time > SANTA_MAX_STALL_TIME) {
+        return false;
+    }
+    if (configs->watchdog.stall_time > 0 && configs->watchdog.sink.write == NULL) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Runs one simulation of Santa Claus live
+ * Actors run in child processes, logged actions are collected by the calling process and passed to the sink
+ * @param configs Simulation configurations
+ * @param sink Sink where to write logged actions to (SANTA_ERR_CONFIG if it or its write callback is NULL)
+ * @param result Pointer to the structure to fill with the result (can be NULL)
+ * @return SANTA_OK => success, other value => error (see santa_strerror())
+ */
+santa_status_t santa_run(const configs_t *configs, const santa_sink_t *sink, santa_result_t *result) {
+    if (!santa_check_configs(configs)) {
+        return SANTA_ERR_CONFIG;
+    }
+    if (sink == NULL || sink->write == NULL) {
+        return SANTA_ERR_CONFIG;
+    }
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    // Allocate memory for storing running processes' PIDs
+    running_processes_t *running_processes;
+    int number_of_processes = (1 + configs->elf_num + configs->reindeer_num);
+    if ((running_processes = malloc(sizeof(running_processes_t) + sizeof(int) * number_of_processes)) == NULL) {
+        return SANTA_ERR_MEMORY;
+    }
+    running_processes->num = 0;
+
+    // Open pipe for collecting logged actions from child processes
+    int log_pipe[2];
+    if (pipe(log_pipe) == -1) {
+        free(running_processes);
+        return SANTA_ERR_PIPE;
+    }
+
+    // Prepare shared memory
+    int shared_mem_id;
+    size_t shared_mem_size = sizeof(shared_data_t) + sizeof(actor_state_t) * number_of_processes
+                             + sizeof(elf_slot_t) * configs->elf_num;
+    if ((shared_mem_id = shmget(IPC_PRIVATE, shared_mem_size, 0600 | IPC_CREAT)) == -1) {
+        close(log_pipe[0]);
+        close(log_pipe[1]);
+        free(running_processes);
+        return SANTA_ERR_SHM_GET;
+    }
+
+    // Attach shared memory (attachment is inherited by child processes)
+    shared_data_t *shared_data;
+    if ((shared_data = shmat(shared_mem_id, NULL, 0)) == (void *)-1) {
+        shmctl(shared_mem_id, IPC_RMID, 0);
+        close(log_pipe[0]);
+        close(log_pipe[1]);
+        free(running_processes);
+        return SANTA_ERR_SHM_ATTACH;
+    }
+
+    // Shared memory is removed after the last process detaches it, so it doesn't leak even if processes crash
+    shmctl(shared_mem_id, IPC_RMID, 0);
+    memset(shared_data, 0, shared_mem_size);
+
+    // Address of shared memory is the same in all child processes (it's inherited)
+    shared_data->elf_slots = (elf_slot_t *)&shared_data->actors[number_of_processes];
+
+    // Prepare semaphores
+    if (!prepare_semaphores(shared_data, configs->elf_num)) {
+        shmdt(shared_data);
+        close(log_pipe[0]);
+        close(log_pipe[1]);
+        free(running_processes);
+        return SANTA_ERR_SEMAPHORE;
+    }
+
+    // Workshop is opened, so elves can get help there
+    shared_data->workshop_open = true;
+
+    // Create needed processes
+    santa_status_t status = SANTA_OK;
+    if (!spawn_santa(configs, log_pipe[1], shared_data, running_processes)) {
+        status = SANTA_ERR_SANTA;
+    } else if (!spawn_elves(configs, log_pipe[1], shared_data, running_processes)) {
+        status = SANTA_ERR_ELF;
+    } else if (!spawn_reindeer(configs, log_pipe[1], shared_data, running_processes)) {
+        status = SANTA_ERR_REINDEER;
+    }
+
+    // Only child processes write to the pipe, so the end of the pipe means all of them have ended
+    close(log_pipe[1]);
+
+    int stalls = 0;
+    if (status != SANTA_OK) {
+        // Terminate already run processes
+        kill_processes(running_processes);
+    } else if ((status = collect_actions(log_pipe[0], sink, configs, shared_data, running_processes, &stalls))
+               != SANTA_OK) {
+        kill_processes(running_processes);
+    } else if (!wait_for_processes(running_processes)) {
+        status = SANTA_ERR_CHILD;
+    }
+
+    if (result != NULL) {
+        struct timespec end_time;
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        result->actions = shared_data->process_num;
+        result->help_rounds = shared_data->help_rounds;
+        result->reindeer_hitched = shared_data->reindeer_hitched_num;
+        result->stalls = stalls;
+        result->elapsed_ms = (double)(end_time.tv_sec - start_time.tv_sec) * 1000
+                             + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1000000;
+    }
+
+    terminate_semaphores(shared_data, configs->elf_num);
+    shmdt(shared_data);
+    close(log_pipe[0]);
+    free(running_processes);
+    return status;
+}
+
+/**
+ * Returns human readable description of the status
+ * @param status Status returned by santa_run()
+ * @return Description of the status
+ */
+const char *santa_strerror(santa_status_t status) {
+    switch (status) {
+        case SANTA_OK:
+            return "Success";
+        case SANTA_ERR_CONFIG:
+            return "Invalid configurations";
+        case SANTA_ERR_MEMORY:
+            return "Cannot allocate memory for storing running processes' PIDs";
+        case SANTA_ERR_PIPE:
+            return "Cannot create or read pipe for logged actions";
+        case SANTA_ERR_SHM_GET:
+            return "Cannot get shared memory";
+        case SANTA_ERR_SHM_ATTACH:
+            return "Cannot attach shared memory";
+        case SANTA_ERR_SEMAPHORE:
+            return "Cannot create one of the semaphores";
+        case SANTA_ERR_SANTA:
+            return "Cannot create process for Santa";
+        case SANTA_ERR_ELF:
+            return "Cannot create process for elf";
+        case SANTA_ERR_REINDEER:
+            return "Cannot create process for reindeer";
+        case SANTA_ERR_SINK:
+            return "Cannot write logged action";
+        case SANTA_ERR_CHILD:
+            return "Some of child processes ended abnormally";
+        case SANTA_ERR_STALL:
+            return "Simulation has stalled";
+    }
+
+    return "Unknown error";
+}
+
+/**
+ * Creates sink writing to the file descriptor
+ * @param fd File descriptor where to write logged actions to
+ * @return Created sink
+ */
+santa_sink_t santa_fd_sink(int fd) {
+    santa_sink_t sink = {fd_sink_write, (void *)(intptr_t)fd};
+
+    return sink;
+}
+
+/**
+ * Creates sink storing logged actions into the memory buffer
+ * @param buffer Buffer to store logged actions to (it should be zero-initialized before the first use)
+ * @return Created sink
+ */
+santa_sink_t santa_buffer_sink(santa_buffer_t *buffer) {
+    santa_sink_t sink = {buffer_sink_write, buffer};
+
+    return sink;
+}
+
+/**
+ * Creates sink passing logged actions to the callback
+ * @param callback Function called for each logged action
+ * @param context Context passed to the callback
+ * @return Created sink
+ */
+santa_sink_t santa_callback_sink(bool (*callback)(void *context, const char *line, size_t length), void *context) {
+    santa_sink_t sink = {callback, context};
+
+    return sink;
+}
+
+/**
+ * Writes logged action into the file descriptor
+ * @param context File descriptor (converted to pointer)
+ * @param line Logged action
+ * @param length Length of the logged action
+ * @return true => success, false => error while writing
+ */
+static bool fd_sink_write(void *context, const char *line, size_t length) {
+    int fd = (int)(intptr_t)context;
+
+    while (length > 0) {
+        ssize_t written = write(fd, line, length);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        line += written;
+        length -= written;
+    }
+
+    return true;
+}
+
+/**
+ * Appends logged action to the memory buffer
+ * @param context Memory buffer
+ * @param line Logged action
+ * @param length Length of the logged action
+ * @return true => success, false => buffer cannot be enlarged
+ */
+static bool buffer_sink_write(void *context, const char *line, size_t length) {
+    santa_buffer_t *buffer = context;
+
+    // Enlarge buffer (+1 for terminating null)
+    if (buffer->length + length + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : LOG_READ_CHUNK;
+        while (buffer->length + length + 1 > capacity) {
+            capacity *= 2;
+        }
+
+        char *data;
+        if ((data = realloc(buffer->data, capacity)) == NULL) {
+            return false;
+        }
+
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->length, line, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+
+    return true;
+}
+
+/**
+ * Logs an action
+ * @param log_fd Write end of the log pipe where to write the action to
+ * @param shared_data Shared data (access to shared memory)
+ * @param action Action name with tags (for ex. %d). Action number will be added automatically
+ * @param ... Replacements for tags
+ */
+static void log_action(int log_fd, shared_data_t *shared_data, const char *action, ...) {
+    va_list tag_replacements;
+    char line[LOG_LINE_MAX];
+
+    va_start(tag_replacements, action);
+
+    // Critical section - getting number and write alert into log pipe
+    sem_wait(&shared_data->numbering_sem);
+    int action_num = ++shared_data->process_num;
+
+    int length = snprintf(line, sizeof(line), "%d: ", action_num);
+    length += vsnprintf(line + length, sizeof(line) - length - 1, action, tag_replacements);
+    if (length > LOG_LINE_MAX - 2) {
+        // Truncated action (place for '\n' must stay)
+        length = LOG_LINE_MAX - 2;
+    }
+
+    // Remember the last action of the actor for the watchdog
+    memcpy(shared_data->actors[actor].action, line, length);
+    shared_data->actors[actor].action[length] = '\0';
+
+    line[length++] = '\n';
+
+    // Lines are shorter than PIPE_BUF, so every write is atomic
+    while (write(log_fd, line, length) == -1 && errno == EINTR);
+    sem_post(&shared_data->numbering_sem);
+    // END of critical section
+
+    va_end(tag_replacements);
+}
+
+/**
+ * Simulates an activity taking the given time (scaled by the time-scale factor)
+ * The process sleeps until an absolute deadline, so interrupted sleeps don't prolong the activity
+ * @param configs Simulation configurations (contains time-scale factor)
+ * @param duration Simulated time of the activity (in ms)
+ */
+static void simulate_activity(const configs_t *configs, int duration) {
+    // Zero-initialized factor means real time (as the rest of zero-initialized configurations means defaults)
+    double time_scale = configs->time_scale > 0 ? configs->time_scale : 1;
+
+    long long sleep_time = (long long)(duration * time_scale * NS_PER_MS + 0.5);
+    if (sleep_time <= 0) {
+        return;
+    }
+
+    // Compute absolute deadline
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    long long deadline_ns = deadline.tv_nsec + sleep_time;
+    deadline.tv_sec += deadline_ns / NS_PER_S;
+    deadline.tv_nsec = deadline_ns % NS_PER_S;
+
+    // Signals only interrupt the sleep, the deadline stays the same
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+}
+
+/**
+ * Passes logged actions from the log pipe to the sink until all child processes close the pipe
+ * If the watchdog is enabled, it checks if there is any progress
+ * @param log_fd Read end of the log pipe
+ * @param sink Sink where to write logged actions to
+ * @param configs Simulation configurations (contains watchdog settings)
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @param stalls Pointer to the variable where to count detected stalls
+ * @return SANTA_OK => success, SANTA_ERR_PIPE => cannot read the log pipe,
+ *         SANTA_ERR_SINK => sink has refused logged action,
+ *         SANTA_ERR_STALL => simulation has stalled and the watchdog should kill it
+ */
+static santa_status_t collect_actions(int log_fd, const santa_sink_t *sink, const configs_t *configs,
+                                      shared_data_t *shared_data, running_processes_t *running_processes,
+                                      int *stalls) {
+    // Buffer contains a part of the last line from the previous chunk at the beginning
+    char buffer[LOG_READ_CHUNK + LOG_LINE_MAX];
+    size_t used = 0;
+
+    // Without watchdog poll() waits infinitely
+    struct pollfd log_poll = {log_fd, POLLIN, 0};
+    int timeout = configs->watchdog.stall_time > 0 ? configs->watchdog.stall_time : -1;
+
+    while (1) {
+        int ready = poll(&log_poll, 1, timeout);
+        if (ready == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return SANTA_ERR_PIPE;
+        } else if (ready == 0) {
+            // No action has been logged for the whole stall time
+            (*stalls)++;
+            dump_state(configs, shared_data, running_processes);
+
+            if (configs->watchdog.kill) {
+                return SANTA_ERR_STALL;
+            }
+
+            continue;
+        }
+
+        ssize_t bytes_read = read(log_fd, buffer + used, LOG_READ_CHUNK);
+        if (bytes_read == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return SANTA_ERR_PIPE;
+        } else if (bytes_read == 0) {
+            // All child processes have closed the pipe
+            return SANTA_OK;
+        }
+        used += bytes_read;
+
+        // Pass complete lines to the sink
+        size_t line_start = 0;
+        for (size_t i = 0; i < used; i++) {
+            if (buffer[i] == '\n') {
+                if (!sink->write(sink->context, buffer + line_start, i + 1 - line_start)) {
+                    return SANTA_ERR_SINK;
+                }
+
+                line_start = i + 1;
+            }
+        }
+
+        // Move incomplete line to the beginning of the buffer
+        memmove(buffer, buffer + line_start, used - line_start);
+        used -= line_start;
+    }
+}
+
+/**
+ * Writes state of the simulation into the watchdog's sink
+ * @param configs Simulation configurations (contains watchdog settings)
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ */
+static void dump_state(const configs_t *configs, shared_data_t *shared_data, running_processes_t *running_processes) {
+    const santa_sink_t *sink = &configs->watchdog.sink;
+
+    dump_line(sink, "Watchdog: no progress for %d ms", configs->watchdog.stall_time);
+
+    // Counters (they're read without locking, so they can be changing right now)
+    dump_line(sink, "Counters: actions=%d reindeer_home=%d reindeer_hitched=%d next_ticket=%d served_tickets=%d "
+                    "help_rounds=%d workshop_open=%d", shared_data->process_num, shared_data->reindeer_home_num,
+              shared_data->reindeer_hitched_num, shared_data->next_ticket, shared_data->served_tickets,
+              shared_data->help_rounds, shared_data->workshop_open);
+
+    // Semaphores
+    struct {
+        const char *name;
+        sem_t *semaphore;
+    } semaphores[] = {
+        {"numbering", &shared_data->numbering_sem},
+        {"reindeer_counting", &shared_data->reindeer_counting_sem},
+        {"wake_santa", &shared_data->wake_santa_sem},
+        {"reindeer_hitched", &shared_data->reindeer_hitched_sem},
+        {"all_reindeer_hitched", &shared_data->all_reindeer_hitched_sem},
+        {"hitched_counting", &shared_data->hitched_counting_sem},
+        {"elf_counting", &shared_data->elf_counting_sem},
+        {"elf_help_done", &shared_data->elf_help_done_sem},
+    };
+    for (int i = 0; i < (int)(sizeof(semaphores) / sizeof(semaphores[0])); i++) {
+        int value;
+        sem_getvalue(semaphores[i].semaphore, &value);
+
+        dump_line(sink, "Semaphore %s: %d", semaphores[i].name, value);
+    }
+
+    // Slots of elves waiting in the queue
+    for (int ticket = shared_data->served_tickets; ticket < shared_data->next_ticket; ticket++) {
+        int value;
+        sem_getvalue(&shared_data->elf_slots[ticket % configs->elf_num].got_help_sem, &value);
+
+        dump_line(sink, "Elf queue ticket %d (slot %d): %d", ticket, ticket % configs->elf_num, value);
+    }
+
+    // Actors - process state and the last logged action
+    for (int i = 0; i < running_processes->num; i++) {
+        char name[16];
+        if (i == 0) {
+            snprintf(name, sizeof(name), "Santa");
+        } else if (i <= configs->elf_num) {
+            snprintf(name, sizeof(name), "Elf %d", i);
+        } else {
+            snprintf(name, sizeof(name), "RD %d", i - configs->elf_num);
+        }
+
+        // Check process state without reaping it (WNOWAIT)
+        char state[32];
+        siginfo_t info;
+        memset(&info, 0, sizeof(info));
+        if (waitid(P_PID, running_processes->pids[i], &info, WEXITED | WNOHANG | WNOWAIT) == -1 || info.si_pid == 0) {
+            snprintf(state, sizeof(state), "running");
+        } else if (info.si_code == CLD_EXITED) {
+            snprintf(state, sizeof(state), "exited with %d", info.si_status);
+        } else {
+            snprintf(state, sizeof(state), "killed by signal %d", info.si_status);
+        }
+
+        const char *action = shared_data->actors[i].action;
+        dump_line(sink, "Actor %s (PID %d, %s): %s", name, running_processes->pids[i], state,
+                  action[0] != '\0' ? action : "no action");
+    }
+}
+
+/**
+ * Writes one formatted line into the sink
+ * @param sink Sink where to write the line to
+ * @param format Line format (without '\n')
+ * @param ... Replacements for tags
+ */
+static void dump_line(const santa_sink_t *sink, const char *format, ...) {
+    va_list tag_replacements;
+    char line[2 * LOG_LINE_MAX];
+
+    va_start(tag_replacements, format);
+    int length = vsnprintf(line, sizeof(line) - 1, format, tag_replacements);
+    va_end(tag_replacements);
+
+    if (length > (int)sizeof(line) - 2) {
+        // Truncated line (place for '\n' must stay)
+        length = sizeof(line) - 2;
+    }
+    line[length++] = '\n';
+
+    sink->write(sink->context, line, length);
+}
+
+/**
+ * Waits for all child processes to end
+ * @param running_processes Running processes
+ * @return true => all processes have ended successfully, false => some of them has ended abnormally
+ */
+static bool wait_for_processes(running_processes_t *running_processes) {
+    bool success = true;
+
+    for (int i = 0; i < running_processes->num; i++) {
+        int exit_status = 0;
+        pid_t pid;
+        while ((pid = waitpid(running_processes->pids[i], &exit_status, 0)) == -1 && errno == EINTR);
+
+        // Process can't be waited for (for ex. the caller ignores SIGCHLD, so it has been reaped automatically)
+        // --> its exit status is unknown
+        if (pid == -1) {
+            success = false;
+        } else if (!WIFEXITED(exit_status) || WEXITSTATUS(exit_status) != 0) {
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+/**
+ * Kills all running child processes and waits for them
+ * @param running_processes Running processes
+ */
+static void kill_processes(running_processes_t *running_processes) {
+    for (int i = 0; i < running_processes->num; i++) {
+        kill(running_processes->pids[i], SIGKILL);
+    }
+
+    wait_for_processes(running_processes);
+}
+
+/**
+ * Prepares all required semaphores
+ * Created semaphores can be safely destroyed by terminate_semaphores() function
+ * <strong>Caution: After modifying this function the terminate_semaphores() function must be updated</strong>
+ * @param shared_data Pointer to the shared data where to store semaphores
+ * @param elf_num Number of elves (slots of the elf queue)
+ * @return true => success, false => error while creating one of the semaphores
+ */
+static bool prepare_semaphores(shared_data_t *shared_data, int elf_num) {
+    // Init semaphore for process numbering
+    if ((sem_init(&shared_data->numbering_sem, 1, 1)) == -1) {
+        return false;
+    }
+
+    // Init semaphore for counting reindeer at home
+    if ((sem_init(&shared_data->reindeer_counting_sem, 1, 1)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    // Init semaphore for blocking Santa from waking up
+    if ((sem_init(&shared_data->wake_santa_sem, 1, 0)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    // Init semaphore for blocking reindeer until its hitched
+    if ((sem_init(&shared_data->reindeer_hitched_sem, 1, 0)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    // Init semaphore for blocking Santa to start Christmas
+    if ((sem_init(&shared_data->all_reindeer_hitched_sem, 1, 0)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    // Init semaphore for counting hitched reindeer
+    if ((sem_init(&shared_data->hitched_counting_sem, 1, 1)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    // Init semaphore for counting elves waiting for help
+    if ((sem_init(&shared_data->elf_counting_sem, 1, 1)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    if ((sem_init(&shared_data->elf_help_done_sem, 1, 0)) == -1) {
+        // Previous semaphores are already created, they need to be destroyed
+        terminate_semaphores(shared_data, elf_num);
+        return false;
+    }
+
+    // Init semaphores for blocking elves in the queue until they get help
+    for (int i = 0; i < elf_num; i++) {
+        if ((sem_init(&shared_data->elf_slots[i].got_help_sem, 1, 0)) == -1) {
+            // Previous semaphores are already created, they need to be destroyed
+            terminate_semaphores(shared_data, elf_num);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Destroys all semaphores created by prepare_semaphores() function
+ * <strong>Caution: It needs to be updated after adding a new semaphore into prepare_semaphore()</strong>
+ * @param shared_data Pointer to the shared data where to store semaphores
+ * @param elf_num Number of elves (slots of the elf queue)
+ */
+static void terminate_semaphores(shared_data_t *shared_data, int elf_num) {
+    sem_destroy(&shared_data->numbering_sem);
+    sem_destroy(&shared_data->reindeer_counting_sem);
+    sem_destroy(&shared_data->wake_santa_sem);
+    sem_destroy(&shared_data->reindeer_hitched_sem);
+    sem_destroy(&shared_data->all_reindeer_hitched_sem);
+    sem_destroy(&shared_data->hitched_counting_sem);
+    sem_destroy(&shared_data->elf_counting_sem);
+    sem_destroy(&shared_data->elf_help_done_sem);
+    for (int i = 0; i < elf_num; i++) {
+        sem_destroy(&shared_data->elf_slots[i].got_help_sem);
+    }
+}
+
+/**
+ * Creates Santa process
+ * @param configs Process configurations
+ * @param log_fd Write end of the log pipe where every action is logged to
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @return true => success, false => problems with process creating
+ */
+static bool spawn_santa(const configs_t *configs, int log_fd, shared_data_t *shared_data,
+                        running_processes_t *running_processes) {
+    // Create a new (child) process by dividing the main process into two processes
+    pid_t pid = fork();
+    if (pid == -1) {
+        // Error while creating the process (child process hasn't been created)
+        return false;
+    } else if (pid == 0) {
+        // Process has been successfully created --> this is code for the new (child) process
+
+        // Set actor index
+        actor = 0;
+
+        // Santa sleeps until interrupt (see code in next block)
+        do {
+            log_action(log_fd, shared_data, "Santa: going to sleep");
+
+            // Sleep until a group of 3 elves is complete or the last reindeer come home
+            sem_wait(&shared_data->wake_santa_sem);
+
+            // Critical section - reindeer can't return home between the check and logging of the decision
+            sem_wait(&shared_data->reindeer_counting_sem);
+            if (shared_data->reindeer_home_num == configs->reindeer_num) {
+                sem_post(&shared_data->reindeer_counting_sem);
+                // END of critical section
+
+                // All reindeer are at home --> let's hitch them
+                // After that Christmas will be started, so elves are without Santa's help from now
+                break;
+            } else {
+                // Elves need help
+
+                log_action(log_fd, shared_data, "Santa: helping elves");
+                sem_post(&shared_data->reindeer_counting_sem);
+                // END of critical section
+
+                shared_data->help_rounds++;
+
+                // Help the oldest group of elves - wake up exactly its members in order of their tickets
+                for (int i = 0; i < 3; i++) {
+                    int ticket = shared_data->served_tickets + i;
+                    sem_post(&shared_data->elf_slots[ticket % configs->elf_num].got_help_sem);
+                    sem_wait(&shared_data->elf_help_done_sem);
+                }
+
+                // Group has been served, the next one can be helped
+                shared_data->served_tickets += 3;
+            }
+        } while (1);
+
+        // Workshop is closed now, so elves can't get help and should go to holiday
+        log_action(log_fd, shared_data, "Santa: closing workshop");
+
+        // Critical section - closing workshop, so no more tickets are given
+        sem_wait(&shared_data->elf_counting_sem);
+        shared_data->workshop_open = false;
+        int next_ticket = shared_data->next_ticket;
+        sem_post(&shared_data->elf_counting_sem);
+        // END of critical section
+
+        // Send waiting elves to holiday
+        // Some of elves aren't at holiday right now and didn't see the info sign at the workshop says "closed"
+        for (int ticket = shared_data->served_tickets; ticket < next_ticket; ticket++) {
+            sem_post(&shared_data->elf_slots[ticket % configs->elf_num].got_help_sem);
+        }
+
+        // Hitch reindeer
+        for (int i = 0; i < configs->reindeer_num; i++) {
+            sem_post(&shared_data->reindeer_hitched_sem);
+        }
+
+        // Wait for all reindeer are hitched
+        sem_wait(&shared_data->all_reindeer_hitched_sem);
+
+        log_action(log_fd, shared_data, "Santa: Christmas started");
+
+        // Child process is done (_exit() doesn't flush stdio buffers inherited from the caller)
+        shmdt(shared_data);
+        _exit(0);
+    } else {
+        // Process has been successfully created --> this is code for original (main) process
+        running_processes->pids[running_processes->num++] = pid;
+    }
+
+    return true;
+}
+
+/**
+ * Creates elf processes
+ * @param configs Process configurations
+ * @param log_fd Write end of the log pipe where every action is logged to
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @return true => success, false => problems with process creating
+ */
+static bool spawn_elves(const configs_t *configs, int log_fd, shared_data_t *shared_data,
+                        running_processes_t *running_processes) {
+    for (int i = 0; i < configs->elf_num; i++) {
+        // Create a new (child) process by dividing the main process into two processes
+        pid_t pid = fork();
+        if (pid == -1) {
+            // Error while creating the process (child process hasn't been created)
+            return false;
+        } else if (pid == 0) {
+            // Process has been successfully created --> this is code for the new (child) process
+
+            // Set identifier
+            id = i + 1;
+            actor = id;
+
+            // Notify about start working action
+            log_action(log_fd, shared_data, "Elf %d: started", id);
+
+            // Elf's working
+            do {
+                // Prepare for randomization - construct seed
+                // Seed is constructed from PID of the child process and microseconds of the current time
+                struct timeval current_time;
+                gettimeofday(&current_time, NULL);
+                srand(getpid() + current_time.tv_usec);
+
+                // Simulate individual working for a pseudorandom time
+                int work_time = rand() % (configs->elf_work + 1);
+                simulate_activity(configs, work_time);
+
+                // Critical section - taking ticket (only while the workshop is opened)
+                // Logging inside makes order of "need help" actions the same as order of tickets
+                sem_wait(&shared_data->elf_counting_sem);
+                log_action(log_fd, shared_data, "Elf %d: need help", id);
+                bool workshop_open = shared_data->workshop_open;
+                int ticket = shared_data->next_ticket;
+                if (workshop_open) {
+                    shared_data->next_ticket++;
+                }
+                sem_post(&shared_data->elf_counting_sem);
+                // END of critical section
+
+                if (!workshop_open) {
+                    // Santa has already started Christmas, so the elf goes to holiday
+
+                    log_action(log_fd, shared_data, "Elf %d: taking holidays", id);
+                    break;
+                } else {
+                    // Wake up Santa if elf has completed a group of 3
+                    if (ticket % 3 == 2) {
+                        sem_post(&shared_data->wake_santa_sem);
+                    }
+
+                    // Wait in own slot for Santa's help
+                    sem_wait(&shared_data->elf_slots[ticket % configs->elf_num].got_help_sem);
+
+                    if (shared_data->workshop_open) {
+                        // Elf got help from Santa
+
+                        log_action(log_fd, shared_data, "Elf %d: get help", id);
+                        sem_post(&shared_data->elf_help_done_sem);
+                    } else {
+                        // Christmas has started yet, so elf won't get help and must go to holiday
+
+                        log_action(log_fd, shared_data, "Elf %d: taking holidays", id);
+                        break;
+                    }
+
+                    // Start next individual work...
+                }
+            } while (1);
+
+            // Child process is done (_exit() doesn't flush stdio buffers inherited from the caller)
+            shmdt(shared_data);
+            _exit(0);
+        } else {
+            // Process has been successfully created --> this is code for original (main) process
+            running_processes->pids[running_processes->num++] = pid;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Creates reindeer processes
+ * @param configs Process configurations
+ * @param log_fd Write end of the log pipe where every action is logged to
+ * @param shared_data Shared data (access to shared memory)
+ * @param running_processes Running processes
+ * @return true => success, false => problems with process creating
+ */
+static bool spawn_reindeer(const configs_t *configs, int log_fd, shared_data_t *shared_data,
+                           running_processes_t *running_processes) {
+    for (int i = 0; i < configs->reindeer_num; i++) {
+        // Create a new (child) process by dividing the main process into two processes
+        pid_t pid = fork();
+        if (pid == -1) {
+            // Error while creating the process (child process hasn't been created)
+            return false;
+        } else if (pid == 0) {
+            // Process has been successfully created --> this is code for the new (child) process
+
+            // Set identifier
+            id = i + 1;
+            actor = 1 + configs->elf_num + i;
+
+            // Notify about go to holiday action
+            log_action(log_fd, shared_data, "RD %d: rstarted", id);
+
+            // Prepare for randomization - construct seed
+            // Seed is constructed from PID of the child process and microseconds of the current time
+            struct timeval current_time;
+            gettimeofday(&current_time, NULL);
+            srand(getpid() + current_time.tv_usec);
+
+            // Simulate holiday for a pseudorandom time
+            int holiday_time = (rand() + (configs->reindeer_holiday / 2)) % (configs->reindeer_holiday + 1);
+            simulate_activity(configs, holiday_time);
+
+            // Critical section - let know reindeer is back at home and increment number of returned reindeer
+            // Both must be done at once, so Santa doesn't start helping elves after all reindeer are at home
+            sem_wait(&shared_data->reindeer_counting_sem);
+            log_action(log_fd, shared_data, "RD %d: return home", id);
+            bool last_reindeer = (++shared_data->reindeer_home_num == configs->reindeer_num);
+            sem_post(&shared_data->reindeer_counting_sem);
+            // END of critical section
+
+            // Waiting for all reindeer are at home to start Christmas
+            // The last-returned reindeer wakes Santa up and he can start hitching reindeer
+            if (last_reindeer) {
+                sem_post(&shared_data->wake_santa_sem);
+            }
+
+            // Wait for the time the reindeer is hitched
+            sem_wait(&shared_data->reindeer_hitched_sem);
+
+            log_action(log_fd, shared_data, "RD %d: get hitched", id);
+
+            // Critical section - counting hitched reindeer
+            sem_wait(&shared_data->hitched_counting_sem);
+            shared_data->reindeer_hitched_num++;
+            sem_post(&shared_data->hitched_counting_sem);
+            // END of critical section
+
+            // All reindeer are hitched --> Santa can start Christmas
+            if (shared_data->reindeer_hitched_num == configs->reindeer_num) {
+                sem_post(&shared_data->all_reindeer_hitched_sem);
+            }
+
+            // Child process is done (_exit() doesn't flush stdio buffers inherited from the caller)
+            shmdt(shared_data);
+            _exit(0);
+        } else {
+            // Process has been successfully created --> this is code for original (main) process
+            running_processes->pids[running_processes->num++] = pid;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,117 @@
+#ifndef SANTA_H
+#define SANTA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Limits of configurations
+#define SANTA_MAX_ELVES 1000            // Maximum number of elves
+#define SANTA_MAX_REINDEER 19           // Maximum number of reindeer
+#define SANTA_MAX_ELF_WORK 1000         // Maximum time of individual elf's work (in ms)
+#define SANTA_MAX_REINDEER_HOLIDAY 1000 // Maximum time of reindeer's holiday (in ms)
+#define SANTA_MAX_TIME_SCALE 1000.0     // Maximum time-scale factor
+#define SANTA_MAX_STALL_TIME 3600000    // Maximum stall time of the watchdog (in ms)
+
+// Sink for logged actions
+// Every action is passed as one line terminated by '\n' (the line isn't null-terminated)
+typedef struct santa_sink {
+    // Writes one line into the sink, returns false if the sink can't accept it
+    bool (*write)(void *context, const char *line, size_t length);
+    // Context passed to the write callback
+    void *context;
+} santa_sink_t;
+
+// Watchdog detecting stalled simulations
+typedef struct santa_watchdog {
+    int stall_time;    // Time without any logged action considered as a stall (in ms), 0 => disabled
+    bool kill;         // Kill the simulation when a stall is detected
+    santa_sink_t sink; // Sink where to write the state dump to (on every detected stall)
+} santa_watchdog_t;
+
+// Configurations of one simulation
+typedef struct configs {
+    int elf_num;               // Number of elves
+    int reindeer_num;          // Number of reindeer
+    int elf_work;              // Maximum time of individual elf's work (in ms)
+    int reindeer_holiday;      // Maximum time of reindeer's holiday (in ms)
+    double time_scale;         // Factor every simulated time is multiplied by (0.01 => 100x faster, 0 or 1 => real time)
+    santa_watchdog_t watchdog; // Stall watchdog (zero-initialized => disabled)
+} configs_t;
+
+// Growing memory buffer for santa_buffer_sink()
+typedef struct santa_buffer {
+    char *data;      // Logged lines (null-terminated), must be freed by free()
+    size_t length;   // Number of used bytes (without terminating null)
+    size_t capacity; // Number of allocated bytes
+} santa_buffer_t;
+
+// Structured result of one simulation
+typedef struct santa_result {
+    int actions;          // Number of logged actions
+    int help_rounds;      // How many times Santa has helped elves
+    int reindeer_hitched; // Number of hitched reindeer
+    int stalls;           // Number of stalls detected by the watchdog
+    double elapsed_ms;    // Wall-clock duration of the simulation (in ms)
+} santa_result_t;
+
+// Result states of santa_run()
+typedef enum santa_status {
+    SANTA_OK = 0,         // Simulation has been successfully completed
+    SANTA_ERR_CONFIG,     // Invalid configurations
+    SANTA_ERR_MEMORY,     // Cannot allocate memory
+    SANTA_ERR_PIPE,       // Cannot create or read pipe for collecting logged actions
+    SANTA_ERR_SHM_GET,    // Cannot get shared memory
+    SANTA_ERR_SHM_ATTACH, // Cannot attach shared memory
+    SANTA_ERR_SEMAPHORE,  // Cannot create one of the semaphores
+    SANTA_ERR_SANTA,      // Cannot create process for Santa
+    SANTA_ERR_ELF,        // Cannot create process for elf
+    SANTA_ERR_REINDEER,   // Cannot create process for reindeer
+    SANTA_ERR_SINK,       // Sink has refused logged action
+    SANTA_ERR_CHILD,      // Some of child processes ended abnormally
+    SANTA_ERR_STALL       // Simulation has stalled and has been killed by the watchdog
+} santa_status_t;
+
+/**
+ * Checks configurations against limits
+ * @param configs Configurations to check
+ * @return true => configurations are valid, false => some of them is out of limits
+ */
+bool santa_check_configs(const configs_t *configs);
+/**
+ * Runs one simulation of Santa Claus live
+ * Actors run in child processes, logged actions are collected by the calling process and passed to the sink
+ * @param configs Simulation configurations
+ * @param sink Sink where to write logged actions to (SANTA_ERR_CONFIG if it or its write callback is NULL)
+ * @param result Pointer to the structure to fill with the result (can be NULL)
+ * @return SANTA_OK => success, other value => error (see santa_strerror())
+ */
+santa_status_t santa_run(const configs_t *configs, const santa_sink_t *sink, santa_result_t *result);
+/**
+ * Returns human readable description of the status
+ * @param status Status returned by santa_run()
+ * @return Description of the status
+ */
+const char *santa_strerror(santa_status_t status);
+
+// Sinks
+/**
+ * Creates sink writing to the file descriptor
+ * @param fd File descriptor where to write logged actions to
+ * @return Created sink
+ */
+santa_sink_t santa_fd_sink(int fd);
+/**
+ * Creates sink storing logged actions into the memory buffer
+ * @param buffer Buffer to store logged actions to (it should be zero-initialized before the first use)
+ * @return Created sink
+ */
+santa_sink_t santa_buffer_sink(santa_buffer_t *buffer);
+/**
+ * Creates sink passing logged actions to the callback
+ * @param callback Function called for each logged action
+ * @param context Context passed to the callback
+ * @return Created sink
+ */
+santa_sink_t santa_callback_sink(bool (*callback)(void *context, const char *line, size_t length), void *context);
+
+#endif // SANTA_H
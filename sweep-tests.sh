@@ -0,0 +1,104 @@
+#!/bin/bash
+# Tests for the sweep mode (--sweep, --jobs)
+# Usage: ./sweep-tests.sh [path to proj2 binary]
+
+PROJ2=$(realpath "${1:-./proj2}")
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+cd "$WORK_DIR" || exit 1
+
+exit_code=0
+
+# Prints result of the test
+# $1 - test name, $2 - 0 => passed, otherwise failed
+report() {
+  if [ "$2" -eq 0 ]; then
+    printf "\e[92mPASSED: %s\e[39m\n" "$1"
+  else
+    printf "\e[91mFAILED: %s\e[39m\n" "$1"
+    exit_code=1
+  fi
+}
+
+# Checks that the row of the results table matches the log file of the simulation
+# $1 - line of the sweep file, $2 - configuration (NE NR TE TR), $3 - expected status
+check_row() {
+  local row
+  row=$(grep -E "^ *$1 +$(echo "$2" | sed -E 's/ +/ +/g') " out.txt) || return 1
+  echo "$row" | grep -Eq " proj2-$1\.out +$3$" || return 1
+
+  # Number of actions in the table is the number of lines in the log file
+  local actions
+  actions=$(echo "$row" | awk '{ print $6 }')
+  [ -f "proj2-$1.out" ] && [ "$(wc -l < "proj2-$1.out")" -eq "$actions" ]
+}
+
+# Sweep file with comments and empty lines - simulations are numbered by lines of the file
+cat > sweep.txt << 'END'
+# NE NR TE TR
+
+5 4 100 100
+# 3 more simulations
+1 1 0 0
+10 19 50 200
+  7 3 1000 10
+END
+
+# All simulations are run and their results are in the table
+"$PROJ2" --time-scale 0.01 --jobs 2 --sweep sweep.txt > out.txt 2> err.txt
+result=$?
+[ $result -eq 0 ] && [ ! -s err.txt ] \
+  && check_row 3 "5 4 100 100" "Success" \
+  && check_row 5 "1 1 0 0" "Success" \
+  && check_row 6 "10 19 50 200" "Success" \
+  && check_row 7 "7 3 1000 10" "Success" \
+  && [ "$(ls proj2-*.out | wc -l)" -eq 4 ] \
+  && grep -q "Santa: Christmas started" proj2-6.out \
+  && grep -q "^4 simulations (0 failed) in .* ms using 2 jobs$" out.txt
+report "simulations are run and numbered by lines" $?
+rm -f proj2-*.out
+
+# Stalled simulation fails, dump lines are marked by the line of the sweep file
+# (lonely elf waits for help while 19 reindeer are on very long holidays)
+printf "3 1 0 0\n1 19 0 1000\n" > sweep.txt
+timeout 10 "$PROJ2" --time-scale 1000 --watchdog 100 --watchdog-kill --sweep sweep.txt > out.txt 2> err.txt
+result=$?
+[ $result -eq 1 ] && check_row 1 "3 1 0 0" "Success" \
+  && grep -q "^ *2 .* proj2-2\.out *Simulation has stalled$" out.txt \
+  && grep -q "^\[line 2\] Watchdog: no progress for 100 ms$" err.txt \
+  && [ "$(grep -vc "^\[line 2\] " err.txt)" -eq 0 ] \
+  && grep -q "^2 simulations (1 failed) " out.txt
+report "stalled simulation is reported" $?
+rm -f proj2-*.out
+
+# Log file which can't be opened is reported with its reason
+printf "3 1 0 0\n3 1 0 0\n" > sweep.txt
+mkdir proj2-2.out
+"$PROJ2" --sweep sweep.txt > out.txt 2> err.txt
+result=$?
+[ $result -eq 1 ] && check_row 1 "3 1 0 0" "Success" \
+  && grep -q "^ *2 .* proj2-2\.out *Cannot open log file: Is a directory$" out.txt
+report "unopenable log file is reported" $?
+rm -rf proj2-*.out
+
+# Invalid sweep files and arguments
+printf "3 1 0 0\n5 4 100\n" > sweep.txt
+"$PROJ2" --sweep sweep.txt > out.txt 2> err.txt
+[ $? -eq 1 ] && grep -q "^Invalid configuration on line 2 of sweep file$" out.txt && ! ls proj2-*.out > /dev/null 2>&1
+report "invalid configuration is rejected" $?
+
+printf "# nothing\n\n" > sweep.txt
+"$PROJ2" --sweep sweep.txt > out.txt 2> err.txt
+[ $? -eq 1 ] && grep -q "^No configuration in sweep file$" out.txt
+report "empty sweep file is rejected" $?
+
+"$PROJ2" --sweep missing.txt > out.txt 2> err.txt
+[ $? -eq 1 ] && grep -q "^Cannot open sweep file$" out.txt
+report "missing sweep file is rejected" $?
+
+printf "3 1 0 0\n" > sweep.txt
+"$PROJ2" --sweep sweep.txt 5 4 100 100 > out.txt 2> err.txt
+[ $? -eq 1 ] && grep -q "^Invalid input argument(s)$" out.txt && ! ls proj2-*.out > /dev/null 2>&1
+report "positional arguments are rejected in sweep mode" $?
+
+exit $exit_code
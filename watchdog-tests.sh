@@ -0,0 +1,78 @@
+#!/bin/bash
+# Tests for the stall watchdog (--watchdog, --watchdog-kill)
+# Usage: ./watchdog-tests.sh [path to proj2 binary]
+
+PROJ2=$(realpath "${1:-./proj2}")
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+cd "$WORK_DIR" || exit 1
+
+exit_code=0
+
+# Prints result of the test
+# $1 - test name, $2 - 0 => passed, otherwise failed
+report() {
+  if [ "$2" -eq 0 ]; then
+    printf "\e[92mPASSED: %s\e[39m\n" "$1"
+  else
+    printf "\e[91mFAILED: %s\e[39m\n" "$1"
+    exit_code=1
+  fi
+}
+
+# Waits (at most 5 s) until the line matching the pattern is dumped into err.txt
+# $1 - pattern of the line
+# Prints the first matching line
+wait_for_line() {
+  for _ in $(seq 50); do
+    if grep -m 1 "$1" err.txt; then
+      return 0
+    fi
+    sleep 0.1
+  done
+
+  return 1
+}
+
+# --watchdog-kill without --watchdog is rejected
+"$PROJ2" --watchdog-kill 5 4 100 100 > out.txt 2> err.txt
+grep -q "Invalid input argument(s)" out.txt && [ ! -s err.txt ]
+report "--watchdog-kill requires --watchdog" $?
+
+# Healthy simulation doesn't trigger the watchdog
+"$PROJ2" --watchdog 1000 --watchdog-kill 5 4 10 10 > out.txt 2> err.txt
+[ $? -eq 0 ] && [ ! -s err.txt ]
+report "no dump without stall" $?
+
+# Lonely elf waits for help while 19 reindeer are on (very long) holidays --> stall
+timeout 10 "$PROJ2" --time-scale 1000 --watchdog 100 --watchdog-kill 1 19 0 1000 > out.txt 2> err.txt
+result=$?
+[ $result -eq 1 ] && grep -q "Simulation has stalled" out.txt \
+  && grep -q "^Watchdog: no progress for 100 ms$" err.txt \
+  && grep -q "^Counters: " err.txt \
+  && grep -q "^Semaphore wake_santa: " err.txt \
+  && grep -q "^Actor Elf 1 (PID [0-9]*, running): [0-9]*: Elf 1: need help$" err.txt
+report "stalled simulation is dumped and killed" $?
+
+# Killed Santa is shown in the dump as a dead process
+# (lonely elf and 19 reindeer on very long holidays --> the simulation is stalled until its processes are killed)
+"$PROJ2" --time-scale 1000 --watchdog 100 1 19 0 1000 > out.txt 2> err.txt &
+proj2_pid=$!
+# Santa's PID is taken from the first dump (PIDs of child processes aren't ordered by their creation)
+santa_pid=$(wait_for_line "^Actor Santa (PID [0-9]*, " | grep -o "PID [0-9]*" | grep -o "[0-9]*")
+if [ -n "$santa_pid" ]; then
+  kill -9 "$santa_pid"
+  wait_for_line "^Actor Santa (PID $santa_pid, killed by signal 9): " > /dev/null
+fi
+# End the stalled simulation
+pids=$(ps -o pid= --ppid "$proj2_pid")
+if [ -n "$pids" ]; then
+  kill -9 $pids
+fi
+wait "$proj2_pid"
+result=$?
+[ -n "$santa_pid" ] && [ $result -eq 1 ] && grep -q "Some of child processes ended abnormally" out.txt \
+  && grep -q "^Actor Santa (PID $santa_pid, killed by signal 9): " err.txt
+report "dead process is shown in the dump" $?
+
+exit $exit_code